@@ -1,133 +1,4071 @@
 #include <cstddef>      // std::size_t
 #include <cstdint>      // std::uint64_t
+#include <cstdlib>      // std::aligned_alloc
+#include <algorithm>    // std::max
+#include <numeric>      // std::gcd
+#include <limits>       // std::numeric_limits (PoolAllocator::max_size)
+#include <tuple>        // std::tuple (size-class pools)
 #include <atomic>       // std::atomic
 #include <new>          // placement new
 #include <type_traits>  // std::aligned_storage
 #include <cassert>      // assert
+#include <cstdio>       // std::fprintf (debug-check reports)
+#include <cstring>      // std::memset (debug-check poisoning)
 #include <array>        // std::array
 #include <iostream>     // std::cout
 #include <thread>       // std::thread::id
+#include <utility>      // std::swap
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>   // mmap, mprotect (growable slab reservation), shm_open
+    #include <sys/stat.h>   // fstat (shared-memory pool)
+    #include <fcntl.h>      // O_CREAT, O_EXCL
+    #include <unistd.h>     // ftruncate, close
+    #include <cerrno>       // errno
+    #define LOCKFREE_POOL_HAS_MMAP 1
+#else
+    #define LOCKFREE_POOL_HAS_MMAP 0
+#endif
+
+#if defined(__linux__)
+    #include <cstdio>               // std::fopen (sysfs node list)
+    #include <linux/mempolicy.h>    // MPOL_PREFERRED, MPOL_MF_MOVE
+    #include <sys/syscall.h>        // SYS_mbind, SYS_getcpu
+    #include <unistd.h>             // syscall
+    #include <sched.h>              // sched_getcpu
+    #define LOCKFREE_POOL_HAS_NUMA 1
+#else
+    #define LOCKFREE_POOL_HAS_NUMA 0
+#endif
+
+//glibc 2.35+ registers a restartable-sequences area for every thread
+#if defined(__linux__) && defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35))
+    #include <sys/rseq.h>           // __rseq_offset, struct rseq
+    #define LOCKFREE_POOL_HAS_RSEQ 1
+#else
+    #define LOCKFREE_POOL_HAS_RSEQ 0
+#endif
+#include <memory>       // std::unique_ptr
+#include <memory_resource> // std::pmr::memory_resource
+#include <vector>       // std::vector (prefault workers, free thread indices)
+#include <mutex>        // std::mutex (thread registry, cold path only)
+#include <chrono>       // std::chrono::steady_clock (shared-pool attach timeout)
+#include <system_error> // std::system_error (shared-memory pool)
+
+//C++20 coroutines: async_allocate() only; the rest of the pool is C++17
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+    #if __has_include(<coroutine>)
+        #include <coroutine>    // std::coroutine_handle
+        #define LOCKFREE_POOL_HAS_COROUTINES 1
+    #endif
+#endif
+#ifndef LOCKFREE_POOL_HAS_COROUTINES
+    #define LOCKFREE_POOL_HAS_COROUTINES 0
+#endif
 
 // ========== Cache Line Alignment ========== //
 #ifndef hardware_destructive_interference_size
     #define hardware_destructive_interference_size 64  // 64-byte cache line for modern CPUs
 #endif
 
-constexpr static std::size_t CACHE_LINE_SIZE = hardware_destructive_interference_size;
+constexpr static std::size_t CACHE_LINE_SIZE = hardware_destructive_interference_size;
+constexpr static std::size_t PAGE_SIZE = 4096;               // Base page on x86-64 / most AArch64 kernels
+constexpr static std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; // 2 MiB huge page (PMD level)
+
+// ========== Double-Width CAS Detection ========== //
+#ifndef LOCKFREE_POOL_HAS_DWCAS
+    #if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+        #define LOCKFREE_POOL_HAS_DWCAS 1  // 128-bit CAS (x86-64 built with -mcx16, AArch64)
+    #else
+        #define LOCKFREE_POOL_HAS_DWCAS 0  // Packed pointer + counter in one 64-bit word
+    #endif
+#endif
+
+/**
+ * @brief Versioned head pointer for a lock-free (Treiber) free list.
+ *
+ * Every successful CAS bumps the tag, so a node that was popped and pushed
+ * back between a thread's load and its CAS no longer compares equal (**ABA-safe**).
+ *
+ * - With DWCAS: full pointer + pointer-sized counter, swapped by one 128-bit CAS.
+ * - Fallback: 48-bit pointer + 16-bit counter packed into one 64-bit word
+ *   (32/32 on 32-bit targets). Assumes user-space pointers fit in 48 bits.
+ *
+ * @tparam Node Free-list node type
+ */
+template<typename Node>
+class TaggedFreeListHead {
+public:
+    struct TaggedPtr {
+        Node* ptr;
+        std::uintptr_t tag;
+    };
+
+    TaggedPtr load(std::memory_order order) const noexcept {
+#if LOCKFREE_POOL_HAS_DWCAS
+        //Halves are read separately; a torn snapshot only makes the next CAS fail.
+        //The tag goes first and carries `order`, so the pointer is at least as new
+        TaggedPtr t;
+        t.tag = __atomic_load_n(&words()[1], toGccOrder(order));
+        t.ptr = reinterpret_cast<Node*>(__atomic_load_n(&words()[0], __ATOMIC_RELAXED));
+        return t;
+#else
+        return unpack(word.load(order));
+#endif
+    }
+
+    /**
+     * @brief Publishes a new head; only safe while no other thread uses the list.
+     */
+    void store(Node* ptr, std::memory_order order) noexcept {
+        TaggedPtr current = load(std::memory_order_relaxed);
+#if LOCKFREE_POOL_HAS_DWCAS
+        __atomic_store_n(&words()[1], current.tag + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&words()[0], reinterpret_cast<std::uintptr_t>(ptr), toGccOrder(order));
+#else
+        word.store(pack(ptr, current.tag + 1), order);
+#endif
+    }
+
+    /**
+     * @brief Swings the head from `expected` to `desired`, bumping the tag.
+     * @return true on success; on failure `expected` holds the current head.
+     *
+     * On x86-64 the 128-bit path is LOCK CMPXCHG16B, a full barrier whatever
+     * is requested; AArch64 gets CASP with exactly the requested orderings.
+     */
+    bool compare_exchange_weak(TaggedPtr& expected, Node* desired,
+                               std::memory_order success,
+                               std::memory_order failure) noexcept {
+#if LOCKFREE_POOL_HAS_DWCAS && defined(__aarch64__)
+        Word oldWord = pack(expected.ptr, expected.tag);
+        if (__atomic_compare_exchange_n(&word, &oldWord, pack(desired, expected.tag + 1), true,
+                                        toGccOrder(success), toGccOrder(failure))) {
+            return true;
+        }
+        expected = unpack(oldWord);
+        return false;
+#elif LOCKFREE_POOL_HAS_DWCAS
+        //__sync, not __atomic: GCC routes 16-byte __atomic calls through libatomic
+        (void)success;
+        (void)failure;
+        const Word oldWord = pack(expected.ptr, expected.tag);
+        const Word newWord = pack(desired, expected.tag + 1);
+        const Word seen = __sync_val_compare_and_swap(&word, oldWord, newWord);
+        if (seen == oldWord) {
+            return true;
+        }
+        expected = unpack(seen);
+        return false;
+#else
+        std::uint64_t oldWord = pack(expected.ptr, expected.tag);
+        if (word.compare_exchange_weak(oldWord, pack(desired, expected.tag + 1), success, failure)) {
+            return true;
+        }
+        expected = unpack(oldWord);
+        return false;
+#endif
+    }
+
+private:
+#if LOCKFREE_POOL_HAS_DWCAS
+    using Word = unsigned __int128;
+
+    alignas(16) Word word = 0;  // low half = pointer, high half = tag
+
+    std::uintptr_t* words() noexcept { return reinterpret_cast<std::uintptr_t*>(&word); }
+    const std::uintptr_t* words() const noexcept { return reinterpret_cast<const std::uintptr_t*>(&word); }
+
+    static constexpr int toGccOrder(std::memory_order order) noexcept {
+        return order == std::memory_order_relaxed ? __ATOMIC_RELAXED
+             : order == std::memory_order_release ? __ATOMIC_RELEASE
+             : order == std::memory_order_acq_rel ? __ATOMIC_ACQ_REL
+             : order == std::memory_order_seq_cst ? __ATOMIC_SEQ_CST
+                                                  : __ATOMIC_ACQUIRE;
+    }
+
+    static Word pack(Node* ptr, std::uintptr_t tag) noexcept {
+        return (static_cast<Word>(tag) << 64) | reinterpret_cast<std::uintptr_t>(ptr);
+    }
+
+    static TaggedPtr unpack(Word w) noexcept {
+        return { reinterpret_cast<Node*>(static_cast<std::uintptr_t>(w)),
+                 static_cast<std::uintptr_t>(w >> 64) };
+    }
+#else
+    static constexpr unsigned PTR_BITS = sizeof(void*) == 8 ? 48 : 32;
+    static constexpr std::uint64_t PTR_MASK = (std::uint64_t{1} << PTR_BITS) - 1;
+
+    std::atomic<std::uint64_t> word{0};
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Packed head needs a lock-free 64-bit CAS");
+
+    static std::uint64_t pack(Node* ptr, std::uintptr_t tag) noexcept {
+        return (static_cast<std::uint64_t>(tag) << PTR_BITS) |
+               (static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(ptr)) & PTR_MASK);
+    }
+
+    static TaggedPtr unpack(std::uint64_t w) noexcept {
+        return { reinterpret_cast<Node*>(static_cast<std::uintptr_t>(w & PTR_MASK)),
+                 static_cast<std::uintptr_t>(w >> PTR_BITS) };
+    }
+#endif
+};
+
+/**
+ * @brief Free-list head as a 32-bit node index plus a 32-bit tag in one
+ *        64-bit word: ABA-safe with a plain single-width CAS, on any target.
+ *
+ * Same interface as TaggedFreeListHead. A node is named by its byte offset
+ * from `base` in units of GRANULE (the slot alignment, a power of two), so
+ * decoding is a shift and an add; the tag is twice as wide as the packed
+ * 48/16 fallback's.
+ *
+ * @tparam Node Free-list node type
+ * @tparam GRANULE Every node offset from `base` is a multiple of this
+ */
+template<typename Node, std::size_t GRANULE>
+class IndexedFreeListHead {
+public:
+    struct TaggedPtr {
+        Node* ptr;
+        std::uint32_t tag;
+    };
+
+    static_assert(GRANULE != 0 && (GRANULE & (GRANULE - 1)) == 0, "GRANULE must be a power of two");
+
+    /**
+     * @brief Sets the address indices count from; call before any other use.
+     */
+    void rebase(const void* newBase) noexcept {
+        base = reinterpret_cast<std::uintptr_t>(newBase);
+    }
+
+    TaggedPtr load(std::memory_order order) const noexcept {
+        return unpack(word.load(order));
+    }
+
+    /**
+     * @brief Publishes a new head; only safe while no other thread uses the list.
+     */
+    void store(Node* ptr, std::memory_order order) noexcept {
+        const TaggedPtr current = load(std::memory_order_relaxed);
+        word.store(pack(ptr, current.tag + 1), order);
+    }
+
+    /**
+     * @brief Swings the head from `expected` to `desired`, bumping the tag.
+     * @return true on success; on failure `expected` holds the current head.
+     */
+    bool compare_exchange_weak(TaggedPtr& expected, Node* desired,
+                               std::memory_order success,
+                               std::memory_order failure) noexcept {
+        std::uint64_t oldWord = pack(expected.ptr, expected.tag);
+        if (word.compare_exchange_weak(oldWord, pack(desired, expected.tag + 1), success, failure)) {
+            return true;
+        }
+        expected = unpack(oldWord);
+        return false;
+    }
+
+private:
+    static constexpr std::uint32_t NIL = 0xFFFFFFFF;
+    static constexpr unsigned SHIFT = __builtin_ctzll(GRANULE);
+
+    std::atomic<std::uint64_t> word{NIL};
+    std::uintptr_t base = 0;
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Indexed head needs a lock-free 64-bit CAS");
+
+    std::uint64_t pack(Node* ptr, std::uint32_t tag) const noexcept {
+        const std::uint32_t index = ptr ? static_cast<std::uint32_t>((reinterpret_cast<std::uintptr_t>(ptr) - base) >> SHIFT)
+                                        : NIL;
+        return static_cast<std::uint64_t>(tag) << 32 | index;
+    }
+
+    TaggedPtr unpack(std::uint64_t w) const noexcept {
+        const auto index = static_cast<std::uint32_t>(w);
+        Node* ptr = index == NIL ? nullptr : reinterpret_cast<Node*>(base + (std::uintptr_t{index} << SHIFT));
+        return { ptr, static_cast<std::uint32_t>(w >> 32) };
+    }
+};
+
+// ========== Exhaustion Policies ========== //
+#if defined(__GNUC__) || defined(__clang__)
+    #define LOCKFREE_POOL_COLD __attribute__((cold, noinline))
+    #define LOCKFREE_POOL_NO_TSAN __attribute__((no_sanitize("thread")))
+#else
+    #define LOCKFREE_POOL_COLD
+    #define LOCKFREE_POOL_NO_TSAN
+#endif
+
+/**
+ * @brief Tells the core it is in a spin-wait loop (PAUSE / YIELD).
+ */
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Hints that `p` is about to be read and written; never faults.
+ */
+inline void prefetchForWrite(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 1, 3);
+#else
+    (void)p;
+#endif
+}
+
+// Stress builds (-DLOCKFREE_POOL_STRESS_PREEMPT=1) yield at random between a
+// CAS loop's snapshot and its CAS, opening the ABA windows a real preemption
+// would on a busy box. Off by default: the call compiles to nothing.
+#ifndef LOCKFREE_POOL_STRESS_PREEMPT
+    #define LOCKFREE_POOL_STRESS_PREEMPT 0
+#endif
+
+/**
+ * @brief Gives up the core about one time in eight (stress builds only).
+ */
+inline void preemptionPoint() noexcept {
+#if LOCKFREE_POOL_STRESS_PREEMPT
+    thread_local std::uint32_t state = 0x9E3779B9u ^ static_cast<std::uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    if ((state & 7) == 0) std::this_thread::yield();
+#endif
+}
+
+/*
+ * What allocate() does when the free list is empty. Each policy is a struct
+ * with one static function taking the pool and a `retry` callable that
+ * re-attempts the pop (returns a slot or nullptr). The policy is picked at
+ * compile time through Traits::ExhaustionPolicy, so unused strategies cost
+ * nothing on the fast path.
+ */
+
+/**
+ * @brief Fail fast: allocate() returns nullptr (default).
+ */
+struct ReturnNullOnExhaustion {
+    template<typename Pool, typename Retry>
+    static void* onExhausted(Pool&, Retry&&) noexcept {
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Busy-wait with exponential backoff until another thread frees a node.
+ * @tparam MAX_RETRIES Give up and return nullptr after this many retries (0 = never)
+ */
+template<std::size_t MAX_RETRIES = 0>
+struct SpinWaitOnExhaustion {
+    static constexpr std::size_t MAX_PAUSES = 1024;
+
+    template<typename Pool, typename Retry>
+    static void* onExhausted(Pool&, Retry&& retry) noexcept {
+        std::size_t pauses = 1;
+        for (std::size_t attempt = 0; MAX_RETRIES == 0 || attempt < MAX_RETRIES; ++attempt) {
+            for (std::size_t i = 0; i < pauses; ++i) {
+                cpuRelax();
+            }
+            if (void* slot = retry()) {
+                return slot;
+            }
+            //Past the cap, let the freeing thread run instead of burning its core
+            if (pauses < MAX_PAUSES) {
+                pauses <<= 1;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Calls a user hook once, then retries (like std::new_handler).
+ *
+ * The hook can release objects, flush caches or raise an alert; if the
+ * retry still finds the pool empty, allocate() returns nullptr.
+ * @tparam Handler Function invoked on exhaustion; must not throw
+ */
+template<void (*Handler)()>
+struct CallbackOnExhaustion {
+    template<typename Pool, typename Retry>
+    static void* onExhausted(Pool&, Retry&& retry) noexcept {
+        Handler();
+        return retry();
+    }
+};
+
+/**
+ * @brief Appends a new slab of N slots, then retries.
+ *
+ * Requires a growable pool (Traits::MAX_SLABS > 1). Returns nullptr only
+ * once every slab is in use or the OS refuses to commit more memory.
+ */
+struct GrowOnExhaustion {
+    template<typename Pool, typename Retry>
+    static void* onExhausted(Pool& pool, Retry&& retry) noexcept {
+        static_assert(Pool::max_slabs() > 1, "GrowOnExhaustion needs Traits::MAX_SLABS > 1");
+        //grow() also reports true while another thread's slab is being spliced in
+        while (pool.grow()) {
+            if (void* slot = retry()) {
+                return slot;
+            }
+            cpuRelax();
+        }
+        return retry();
+    }
+};
+
+// ========== Backoff Policies ========== //
+/*
+ * What a CAS loop on a shared list (freeList, a remote-free queue, the lazy
+ * watermark) does after a failed attempt, picked through Traits::Backoff.
+ * A fresh policy object lives for one operation; operator() runs after
+ * every failure and returns true if it paused, telling the loop that its
+ * snapshot is stale and worth reloading before the next attempt.
+ */
+
+/**
+ * @brief Retry at once (default); best while few threads share one pool.
+ */
+struct NoBackoff {
+    constexpr bool operator()() noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief Pause 1, 2, 4 ... MAX_PAUSES times between attempts.
+ * @tparam MAX_PAUSES Cap on pauses per failure; a power of two
+ * @tparam YIELD_AT_MAX Give up the CPU instead once the cap is reached
+ */
+template<std::uint32_t MAX_PAUSES = 64, bool YIELD_AT_MAX = false>
+struct ExponentialBackoff {
+    static_assert(MAX_PAUSES != 0 && (MAX_PAUSES & (MAX_PAUSES - 1)) == 0, "MAX_PAUSES must be a power of two");
+    std::uint32_t pauses = 1;
+
+    bool operator()() noexcept {
+        if (YIELD_AT_MAX && pauses == MAX_PAUSES) {
+            std::this_thread::yield();
+            return true;
+        }
+        for (std::uint32_t i = 0; i < pauses; ++i) cpuRelax();
+        if (pauses < MAX_PAUSES) pauses <<= 1;
+        return true;
+    }
+};
+
+/**
+ * @brief Exponential cap, but a random pause count below it, so threads
+ *        that collided once do not retry in lockstep and collide again.
+ * @tparam MAX_PAUSES Cap on pauses per failure; a power of two
+ */
+template<std::uint32_t MAX_PAUSES = 64>
+struct RandomizedBackoff {
+    static_assert(MAX_PAUSES >= 2 && (MAX_PAUSES & (MAX_PAUSES - 1)) == 0, "MAX_PAUSES must be a power of two");
+    std::uint32_t limit = 2;
+
+    bool operator()() noexcept {
+        //xorshift32, seeded per thread from the address of its own state
+        thread_local std::uint32_t rng = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&rng) >> 4) | 1;
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        for (std::uint32_t i = rng & (limit - 1); i > 0; --i) cpuRelax();
+        if (limit < MAX_PAUSES) limit <<= 1;
+        return true;
+    }
+};
+
+// ========== Memory Ordering Policies ========== //
+/*
+ * Orderings for the operations every free list repeats: the head a pop
+ * dereferences, the pop CAS and the push CAS, each with its own success
+ * and failure order. Picked through Traits::Ordering. The remaining
+ * atomics (epochs, waiter count, magazine claims, slab states) follow
+ * fixed protocols, documented where they are used.
+ */
+
+/**
+ * @brief The weakest orderings that keep the lists correct (default).
+ *
+ * A push releases the node's link and the freed object; a pop acquires
+ * them. A successful pop need not release: every head update is a CAS,
+ * and a read-modify-write continues the release sequence it read from,
+ * so whoever pops the next node still synchronizes with its pusher. A
+ * failed pop dereferences the head it reloads, so it acquires too; a
+ * failed push only relinks its tail, so it stays relaxed. On AArch64 the
+ * CAS becomes CASA/CASL (LSE) instead of CASAL, with no extra barrier.
+ */
+struct MinimalOrdering {
+    static constexpr std::memory_order HEAD_LOAD = std::memory_order_acquire;
+    static constexpr std::memory_order POP = std::memory_order_acquire;
+    static constexpr std::memory_order POP_FAILURE = std::memory_order_acquire;
+    static constexpr std::memory_order PUSH = std::memory_order_release;
+    // Also the snapshot a push starts from
+    static constexpr std::memory_order PUSH_FAILURE = std::memory_order_relaxed;
+};
+
+/**
+ * @brief seq_cst throughout: the baseline to benchmark MinimalOrdering
+ *        against, and a quick way to rule orderings out in a race hunt.
+ */
+struct SeqCstOrdering {
+    static constexpr std::memory_order HEAD_LOAD = std::memory_order_seq_cst;
+    static constexpr std::memory_order POP = std::memory_order_seq_cst;
+    static constexpr std::memory_order POP_FAILURE = std::memory_order_seq_cst;
+    static constexpr std::memory_order PUSH = std::memory_order_seq_cst;
+    static constexpr std::memory_order PUSH_FAILURE = std::memory_order_seq_cst;
+};
+
+// ========== Thread Registry ========== //
+/**
+ * @brief Hands out dense thread indices and takes them back at thread exit.
+ *
+ * Before an exiting thread's index is recycled, every live pool gets to
+ * flush that thread's magazines and remote-free queue back to its shared
+ * free list, so churning worker threads never leak capacity. Pools detach
+ * in their destructor under the same lock, so an exit flush never touches
+ * a destroyed pool. Only thread start/exit and pool construction/destruction
+ * take the lock; allocation never does.
+ */
+class ThreadRegistry {
+public:
+    // Work a flush leaves for after the lock drops, chained through `next`:
+    // resuming a coroutine there may construct or destroy a pool
+    struct Deferred {
+        void (*run)(void* context) noexcept = nullptr;
+        void* context = nullptr;
+        Deferred* next = nullptr;
+    };
+
+    using FlushFn = Deferred* (*)(void* pool, std::size_t threadIndex) noexcept;
+
+    // Intrusive list node embedded in every pool
+    struct Hook {
+        FlushFn flush = nullptr;
+        void* pool = nullptr;
+        Hook* prev = nullptr;
+        Hook* next = nullptr;
+    };
+
+    //Never destroyed: thread_local destructors may still run after statics
+    static ThreadRegistry& instance() {
+        static ThreadRegistry* const registry = new ThreadRegistry();
+        return *registry;
+    }
+
+    std::size_t acquireIndex() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeIndices.empty()) {
+            const std::size_t index = freeIndices.back();
+            freeIndices.pop_back();
+            return index;
+        }
+        return nextIndex++;
+    }
+
+    void releaseIndex(std::size_t index) noexcept {
+        Deferred* deferred = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Hook* hook = hooks; hook; hook = hook->next) {
+                Deferred* chain = hook->flush(hook->pool, index);
+                if (!chain) continue;
+                Deferred* last = chain;
+                while (last->next) last = last->next;
+                last->next = deferred;
+                deferred = chain;
+            }
+            try {
+                freeIndices.push_back(index);
+            } catch (...) {
+                //Out of memory: the index is simply never reused
+            }
+        }
+        runDeferred(deferred);
+    }
+
+    static void runDeferred(Deferred* deferred) noexcept {
+        while (deferred) {
+            //Running it may end the lifetime of the object it lives in
+            Deferred* next = deferred->next;
+            deferred->run(deferred->context);
+            deferred = next;
+        }
+    }
+
+    void attach(Hook& hook) noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        hook.prev = nullptr;
+        hook.next = hooks;
+        if (hooks) hooks->prev = &hook;
+        hooks = &hook;
+    }
+
+    void detach(Hook& hook) noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (hook.prev) hook.prev->next = hook.next;
+        else hooks = hook.next;
+        if (hook.next) hook.next->prev = hook.prev;
+        hook.prev = hook.next = nullptr;
+    }
+
+private:
+    std::mutex mutex;
+    Hook* hooks = nullptr;
+    std::vector<std::size_t> freeIndices;
+    std::size_t nextIndex = 0;
+};
+
+//Index of a thread that has not asked yet
+constexpr static std::size_t UNASSIGNED_THREAD_INDEX = ~std::size_t{0};
+//Index of a thread whose index went back to the registry at exit
+constexpr static std::size_t RELEASED_THREAD_INDEX = UNASSIGNED_THREAD_INDEX - 1;
+
+/**
+ * @brief Small dense id for the calling thread, handed out on first use.
+ *
+ * Pools use it to find the calling thread's magazine in their own
+ * per-instance table, so caches are never shared between pool objects.
+ * Indices of exited threads are reused, so they stay below the number of
+ * threads alive at once.
+ *
+ * The index is given back by a thread_local built on first use. Thread
+ * locals built earlier in the same thread are destroyed after it, and may
+ * still free into a pool. From then on this returns RELEASED_THREAD_INDEX,
+ * which is past every pool's MAX_THREADS. Those late frees skip the magazines
+ * that were already flushed, and that another thread may own by now, and go
+ * straight to the shared lists.
+ */
+inline std::size_t currentThreadIndex() noexcept {
+    //Trivially destructible, so it stays readable through the whole thread exit
+    thread_local std::size_t index = UNASSIGNED_THREAD_INDEX;
+    if (index == UNASSIGNED_THREAD_INDEX) {
+        struct Release {
+            ~Release() {
+                const std::size_t released = index;
+                index = RELEASED_THREAD_INDEX;
+                ThreadRegistry::instance().releaseIndex(released);
+            }
+        };
+        index = ThreadRegistry::instance().acquireIndex();
+        thread_local const Release release;
+        (void)release;
+    }
+    return index;
+}
+
+// ========== NUMA Topology ========== //
+// Raw syscalls rather than libnuma, so NUMA mode adds no link dependency.
+
+constexpr static int NO_NUMA_NODE = -1;
+
+/**
+ * @brief Number of online NUMA nodes (1 when unknown or not Linux).
+ */
+inline std::size_t numaNodeCount() noexcept {
+    static const std::size_t count = [] {
+        std::size_t nodes = 1;
+#if LOCKFREE_POOL_HAS_NUMA
+        //Format is a range list such as "0" or "0-1"; the highest id wins
+        if (std::FILE* file = std::fopen("/sys/devices/system/node/online", "r")) {
+            unsigned first = 0, last = 0;
+            while (std::fscanf(file, "%u", &first) == 1) {
+                last = first;
+                if (std::fscanf(file, "-%u", &last) < 1) last = first;
+                nodes = std::max<std::size_t>(nodes, last + 1);
+                if (std::fgetc(file) != ',') break;
+            }
+            std::fclose(file);
+        }
+#endif
+        return nodes;
+    }();
+    return count;
+}
+
+/**
+ * @brief NUMA node the calling thread was running on when it first asked.
+ *
+ * Cached per thread: pinned trading threads never migrate, and a stale
+ * answer only costs remote latency, never correctness.
+ */
+inline std::size_t currentNumaNode() noexcept {
+    thread_local const std::size_t node = [] {
+        unsigned cpu = 0, numaNode = 0;
+#if LOCKFREE_POOL_HAS_NUMA
+        if (syscall(SYS_getcpu, &cpu, &numaNode, nullptr) != 0) numaNode = 0;
+#endif
+        (void)cpu;
+        return static_cast<std::size_t>(numaNode);
+    }();
+    return node;
+}
+
+/**
+ * @brief CPU the calling thread is running on, or -1 if unknown.
+ *
+ * Reads the cpu_id the kernel keeps current in the thread's rseq area: one
+ * plain load, no syscall. Without rseq, sched_getcpu() (a vDSO call on
+ * x86-64). Either way the answer may be stale by the time it is used, so
+ * per-CPU data indexed by it still needs its own guard.
+ */
+inline int currentCpu() noexcept {
+#if LOCKFREE_POOL_HAS_RSEQ
+    if (__rseq_size != 0) {
+        const auto* area = reinterpret_cast<const struct rseq*>(
+            static_cast<const char*>(__builtin_thread_pointer()) + __rseq_offset);
+        const auto cpu = static_cast<int>(__atomic_load_n(&area->cpu_id, __ATOMIC_RELAXED));
+        if (cpu >= 0) return cpu;  // Negative: registration failed or pending
+    }
+#endif
+#if LOCKFREE_POOL_HAS_NUMA
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Asks the kernel to place the pages of [addr, addr + bytes) on `node`.
+ *
+ * MPOL_PREFERRED rather than MPOL_BIND, so a full node degrades to remote
+ * memory instead of failing. Already-resident pages are migrated.
+ * `addr` must be page aligned.
+ */
+inline bool bindToNumaNode(void* addr, std::size_t bytes, int node) noexcept {
+#if LOCKFREE_POOL_HAS_NUMA
+    if (node < 0 || node >= static_cast<int>(8 * sizeof(unsigned long))) return false;
+    const unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, addr, bytes, MPOL_PREFERRED, &mask, 8 * sizeof(mask), MPOL_MF_MOVE) == 0;
+#else
+    (void)addr; (void)bytes; (void)node;
+    return false;
+#endif
+}
+
+// ========== Backing Store Policies ========== //
+/*
+ * Where slab memory comes from (Traits::BackingStore). Each policy provides:
+ *   GRANULARITY              page size it maps with; slabs are multiples of it
+ *   allocate(bytes, align)   fixed-pool buffer, not yet touched (nullptr on failure)
+ *   deallocate(p, bytes)     release a buffer from allocate()
+ *   prepare(p, bytes)        called after any NUMA binding and before the
+ *                            free-list init loop: advise, lock, pre-fault
+ * Growable pools always reserve their own address space and call prepare()
+ * on each slab they commit.
+ */
+
+#if LOCKFREE_POOL_HAS_MMAP
+/**
+ * @brief Anonymous mapping whose start is aligned to `alignment` (a power of two).
+ * @return nullptr on failure.
+ */
+inline void* mapAligned(std::size_t bytes, std::size_t alignment, int prot, int flags) noexcept {
+    const std::size_t padded = bytes + (alignment > PAGE_SIZE ? alignment : 0);
+    void* region = mmap(nullptr, padded, prot, flags | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) return nullptr;
+
+    //Trim the slack before and after the aligned window
+    auto* start = static_cast<std::byte*>(region);
+    auto* aligned = reinterpret_cast<std::byte*>(
+        (reinterpret_cast<std::uintptr_t>(start) + alignment - 1) & ~(alignment - 1));
+    if (aligned != start) munmap(start, static_cast<std::size_t>(aligned - start));
+    const std::size_t tail = padded - static_cast<std::size_t>(aligned - start) - bytes;
+    if (tail != 0) munmap(aligned + bytes, tail);
+    return aligned;
+}
+#endif
+
+/**
+ * @brief Touches every page of [p, p + bytes) so no fault is left for the hot path.
+ * @param threads Split the range across this many threads (huge pools fault in faster)
+ */
+inline void prefaultPages(void* p, std::size_t bytes, unsigned threads) noexcept {
+    auto touch = [](std::byte* first, std::size_t length) noexcept {
+#if defined(MADV_POPULATE_WRITE)
+        if (madvise(first, length, MADV_POPULATE_WRITE) == 0) return;
+#endif
+        //Atomic OR with 0 forces a writable page without ever changing a byte,
+        //so it is safe even if a lazy pool already handed out slots on it
+        for (std::size_t offset = 0; offset < length; offset += PAGE_SIZE) {
+            __atomic_fetch_or(reinterpret_cast<unsigned char*>(first + offset), 0, __ATOMIC_RELAXED);
+        }
+    };
+
+    auto* base = static_cast<std::byte*>(p);
+    if (threads <= 1 || bytes <= threads * HUGE_PAGE_SIZE) {
+        touch(base, bytes);
+        return;
+    }
+
+    //Page-aligned chunks so no page is split between two workers
+    const std::size_t chunk = (bytes / threads + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    std::vector<std::thread> workers;
+    try {
+        for (std::size_t offset = chunk; offset < bytes; offset += chunk) {
+            workers.emplace_back(touch, base + offset, std::min(chunk, bytes - offset));
+        }
+    } catch (...) {
+        //Could not spawn: the remaining chunks are touched below by the caller
+    }
+    const std::size_t covered = chunk * (workers.size() + 1);
+    touch(base, chunk);
+    if (covered < bytes) touch(base + covered, bytes - covered);
+    for (auto& worker : workers) worker.join();
+}
+
+/**
+ * @brief General-purpose heap via std::aligned_alloc (default).
+ */
+struct HeapBackingStore {
+    static constexpr std::size_t GRANULARITY = PAGE_SIZE;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+        //aligned_alloc() wants the size to be a multiple of the alignment
+        return std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+    }
+
+    static void deallocate(void* p, std::size_t) noexcept {
+        std::free(p);
+    }
+
+    static void prepare(void*, std::size_t) noexcept {}
+};
+
+enum class HugePages {
+    None,         // 4 KiB pages
+    Transparent,  // madvise(MADV_HUGEPAGE) on a 2 MiB-aligned mapping
+    HugeTlb       // MAP_HUGETLB from the reserved hugetlbfs pool, else Transparent
+};
+
+/**
+ * @brief Dedicated anonymous mapping with optional huge pages, mlock and pre-faulting.
+ *
+ * Gives predictable first-access latency for very large pools: no page
+ * faults during trading hours and far fewer TLB misses on random slots.
+ *
+ * @tparam PAGES Huge-page mode
+ * @tparam LOCK mlock() the region so it is never reclaimed or swapped (best effort,
+ *         bounded by RLIMIT_MEMLOCK)
+ * @tparam PREFAULT_THREADS Pre-fault every page with this many threads (0 = on demand)
+ */
+template<HugePages PAGES = HugePages::Transparent, bool LOCK = false, unsigned PREFAULT_THREADS = 0>
+struct MmapBackingStore {
+    static_assert(LOCKFREE_POOL_HAS_MMAP, "MmapBackingStore needs mmap");
+    static constexpr std::size_t GRANULARITY = PAGES == HugePages::None ? PAGE_SIZE : HUGE_PAGE_SIZE;
+
+    static std::size_t mappedBytes(std::size_t bytes) noexcept {
+        return (bytes + GRANULARITY - 1) / GRANULARITY * GRANULARITY;
+    }
+
+    static void* allocate(std::size_t bytes, std::size_t alignment) noexcept {
+#if LOCKFREE_POOL_HAS_MMAP
+        const std::size_t length = mappedBytes(bytes);
+        const std::size_t align = std::max(alignment, GRANULARITY);
+#if defined(MAP_HUGETLB)
+        if constexpr (PAGES == HugePages::HugeTlb) {
+            //Huge TLB mappings come back huge-page aligned already
+            void* region = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (region != MAP_FAILED) return region;
+        }
+#endif
+        return mapAligned(length, align, PROT_READ | PROT_WRITE, 0);
+#else
+        (void)bytes; (void)alignment;
+        return nullptr;
+#endif
+    }
+
+    static void deallocate(void* p, std::size_t bytes) noexcept {
+#if LOCKFREE_POOL_HAS_MMAP
+        munmap(p, mappedBytes(bytes));
+#endif
+    }
+
+    static void prepare(void* p, std::size_t bytes) noexcept {
+#if LOCKFREE_POOL_HAS_MMAP
+        const std::size_t length = mappedBytes(bytes);
+#if defined(MADV_HUGEPAGE)
+        //No-op on hugetlb ranges; asks khugepaged for 2 MiB pages otherwise
+        if constexpr (PAGES != HugePages::None) madvise(p, length, MADV_HUGEPAGE);
+#endif
+        if constexpr (PREFAULT_THREADS > 0) prefaultPages(p, length, PREFAULT_THREADS);
+        if constexpr (LOCK) mlock(p, length);  //Also faults in whatever is left
+#else
+        (void)p; (void)bytes;
+#endif
+    }
+};
+
+// ========== Slot Layout Policies ========== //
+/*
+ * How slots are laid out in a slab (Traits::SlotLayout). A policy maps the
+ * minimum slot size/alignment (already max'ed with the free-list node) to the
+ * stride between consecutive slots. The pool static_asserts the result.
+ */
+
+constexpr std::size_t roundUpTo(std::size_t value, std::size_t multiple) noexcept {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+/**
+ * @brief Densest legal layout: stride = size rounded up to alignment (default).
+ *
+ * Best for objects scanned sequentially or owned by a single thread.
+ */
+struct PackedSlots {
+    template<std::size_t SIZE, std::size_t ALIGN>
+    static constexpr std::size_t stride() noexcept {
+        return roundUpTo(SIZE, ALIGN);
+    }
+};
+
+/**
+ * @brief Every slot starts on its own cache line(s).
+ *
+ * For objects written by different threads; replaces putting
+ * alignas(CACHE_LINE_SIZE) on the object type itself.
+ */
+struct CacheLinePaddedSlots {
+    template<std::size_t SIZE, std::size_t ALIGN>
+    static constexpr std::size_t stride() noexcept {
+        return roundUpTo(SIZE, ALIGN > CACHE_LINE_SIZE ? ALIGN : CACHE_LINE_SIZE);
+    }
+};
+
+/**
+ * @brief Caller-chosen stride, e.g. half a cache line for 32-byte objects.
+ * @tparam STRIDE Bytes between slots; must fit and align the object
+ */
+template<std::size_t STRIDE>
+struct FixedStrideSlots {
+    template<std::size_t SIZE, std::size_t ALIGN>
+    static constexpr std::size_t stride() noexcept {
+        return STRIDE;
+    }
+};
+
+// ========== Object Reset Policies ========== //
+/*
+ * What WarmObjectPool::release() does to an object before it is handed out
+ * again (Traits::Reset): a callable taking T&, run on the releasing thread
+ * while the object is still in its cache. It must not throw.
+ */
+
+/**
+ * @brief Calls `obj.reset()` (default).
+ */
+struct CallReset {
+    template<typename U>
+    void operator()(U& obj) const noexcept(noexcept(obj.reset())) {
+        obj.reset();
+    }
+};
+
+/**
+ * @brief Leaves released objects as they are; the next user overwrites them.
+ */
+struct NoReset {
+    template<typename U>
+    void operator()(U&) const noexcept {}
+};
+
+// ========== Debug Checks ========== //
+// Build with -DLOCKFREE_POOL_DEBUG=1, or set Traits::DEBUG_CHECKS, to make
+// the pools validate every pointer they are given. Every check sits behind
+// `if constexpr`, so with the default of 0 the fast path compiles as before.
+#ifndef LOCKFREE_POOL_DEBUG
+    #define LOCKFREE_POOL_DEBUG 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+    #define LOCKFREE_POOL_HAS_ASAN 1   // GCC, clang >= 18
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define LOCKFREE_POOL_HAS_ASAN 1
+    #endif
+#endif
+#ifndef LOCKFREE_POOL_HAS_ASAN
+    #define LOCKFREE_POOL_HAS_ASAN 0
+#endif
+#if LOCKFREE_POOL_HAS_ASAN
+    #include <sanitizer/asan_interface.h>  // ASAN_POISON_MEMORY_REGION
+#endif
+
+// Written over a freed slot (past its link) and checked when it is reused
+constexpr static unsigned char POOL_POISON_BYTE = 0xDD;
+
+/**
+ * @brief Makes ASan report any access to `bytes` at `p`; no-op without ASan.
+ */
+inline void poisonRegion(const void* p, std::size_t bytes) noexcept {
+#if LOCKFREE_POOL_HAS_ASAN
+    ASAN_POISON_MEMORY_REGION(p, bytes);
+#else
+    (void)p; (void)bytes;
+#endif
+}
+
+/**
+ * @brief Undoes poisonRegion().
+ */
+inline void unpoisonRegion(const void* p, std::size_t bytes) noexcept {
+#if LOCKFREE_POOL_HAS_ASAN
+    ASAN_UNPOISON_MEMORY_REGION(p, bytes);
+#else
+    (void)p; (void)bytes;
+#endif
+}
+
+/**
+ * @brief Reports misuse found by the debug checks to stderr and aborts.
+ */
+[[noreturn]] LOCKFREE_POOL_COLD inline void poolMisuse(const char* what, const void* ptr) noexcept {
+    std::fprintf(stderr, "LockFreeFixedSizeMemoryPool: %s (%p)\n", what, ptr);
+    std::abort();
+}
+
+// ========== Statistics ========== //
+// Buckets of the CAS retry histogram: bucket 0 counts operations that
+// succeeded first time, bucket b > 0 those that needed [2^(b-1), 2^b)
+// retries; the last bucket takes everything above.
+constexpr std::size_t POOL_STATS_RETRY_BUCKETS = 8;
+
+/**
+ * @brief Aggregated pool counters, see LockFreeFixedSizeMemoryPool::snapshot().
+ */
+struct PoolStats {
+    std::uint64_t allocations = 0;     // Slots handed out
+    std::uint64_t frees = 0;           // Slots given back
+    std::uint64_t cache_hits = 0;      // Allocations served by the thread's magazines
+    std::uint64_t global_pops = 0;     // Successful pops (single or batch) off the shared list
+    std::uint64_t cas_retries = 0;     // Failed CAS attempts on the shared list
+    std::uint64_t fallbacks = 0;       // Allocations that fell through to ExhaustionPolicy
+    std::uint64_t in_use = 0;          // allocations - frees at snapshot time
+    std::uint64_t high_water_mark = 0; // Peak of in_use
+    std::array<std::uint64_t, POOL_STATS_RETRY_BUCKETS> cas_retry_histogram{};
+};
+
+/**
+ * @brief Compile-time tuning knobs for LockFreeFixedSizeMemoryPool.
+ *
+ * Derive from this struct and override only what you need:
+ * @code
+ * struct BlockingTraits : DefaultPoolTraits {
+ *     static constexpr std::size_t MAGAZINE_SIZE = 128;
+ *     using ExhaustionPolicy = SpinWaitOnExhaustion<>;
+ * };
+ * LockFreeFixedSizeMemoryPool<Order, 1 << 20, BlockingTraits> pool;
+ * @endcode
+ */
+struct DefaultPoolTraits {
+    // Nodes per magazine; each thread caches at most two magazines per pool
+    static constexpr std::size_t MAGAZINE_SIZE = 32;
+    // Threads with an index at or above this bypass the magazines
+    static constexpr std::size_t MAX_THREADS = 64;
+    // One magazine pair per CPU instead of per thread, for many short-lived
+    // or migrating threads: the cache scales with cores and stays warm.
+    // Every allocate and free pays an atomic exchange to claim the CPU's
+    // magazine, about twice the per-thread cost in BM_Lifo (36 vs 18 ns/op
+    // on one CPU); it only wins once live threads pass MAX_THREADS or far
+    // outnumber the CPUs they run on. No multi-core crossover measured yet.
+    static constexpr bool PER_CPU_CACHE = false;
+    // CPUs with an id at or above this bypass the magazines (PER_CPU_CACHE)
+    static constexpr std::size_t MAX_CPUS = 64;
+    // What allocate() does when the pool is empty
+    using ExhaustionPolicy = ReturnNullOnExhaustion;
+    // Slabs of N slots the pool may grow to; 1 = fixed capacity
+    static constexpr std::size_t MAX_SLABS = 1;
+    // Node pools a NumaLockFreeFixedSizeMemoryPool can hold
+    static constexpr std::size_t MAX_NUMA_NODES = 8;
+    // Where slab memory comes from, see MmapBackingStore for huge pages
+    using BackingStore = HeapBackingStore;
+    // Carve never-used slots from a watermark instead of linking all N up front
+    static constexpr bool LAZY_INIT = false;
+    // Stride between slots: PackedSlots, CacheLinePaddedSlots or FixedStrideSlots<B>
+    using SlotLayout = PackedSlots;
+    // How WarmObjectPool::release() readies an object for reuse: CallReset or NoReset
+    using Reset = CallReset;
+    // Frees from a thread other than the allocating one go to the owner's
+    // remote-free queue (one byte-pair per slot records the owner)
+    static constexpr bool REMOTE_FREE = false;
+    // Per-thread counters and a CAS retry histogram, read with snapshot()
+    static constexpr bool STATS = false;
+    // Pause between failed CAS attempts: NoBackoff, ExponentialBackoff<>, RandomizedBackoff<>
+    using Backoff = NoBackoff;
+    // Free-list CAS orderings: MinimalOrdering or SeqCstOrdering
+    using Ordering = MinimalOrdering;
+    // A refill needing this many failed CAS attempts makes the thread's next
+    // refill take two magazines in one batch; 0 = always one
+    static constexpr std::size_t CONTENDED_REFILL_RETRIES = 0;
+    // Epoch-protect reads of other threads' free nodes so free slabs can be
+    // handed back to the OS while threads allocate (growable pools only)
+    static constexpr bool SAFE_RECLAIM = false;
+    // trim() never leaves fewer resident slabs than this
+    static constexpr std::size_t TRIM_KEEP_SLABS = 1;
+    // Consecutive trim() calls that must find a slab fully free before it is
+    // released, so a pool hovering around a slab boundary does not thrash
+    static constexpr std::size_t TRIM_DECAY = 2;
+    // Free-list head holds a 32-bit slot index + 32-bit tag instead of a
+    // pointer (IndexedFreeListHead): one 64-bit CAS, no DWCAS needed
+    static constexpr bool INDEXED_FREE_LIST = false;
+    // Prefetch the slot after the one allocate() returns, hiding the
+    // dependent load of its `next` and warming it for the next constructor
+    static constexpr bool PREFETCH_NEXT = true;
+    // Abort with a message on double frees, foreign or misaligned pointers
+    // and writes to freed slots; ASan builds also poison free slots
+    static constexpr bool DEBUG_CHECKS = LOCKFREE_POOL_DEBUG;
+    // One bit per slot, set while it is handed out, so for_each_live() can
+    // walk the live objects; costs an atomic RMW per allocate and free
+    static constexpr bool TRACK_LIVE = false;
+    // deallocate() hands freed slots straight to coroutines parked in
+    // async_allocate() (C++20); costs a full fence and one load per free
+    static constexpr bool AWAITABLE = false;
+};
+
+/**
+ * @brief Ultra-low-latency lock-free memory pool for fixed-size objects.
+ * 
+ * This memory pool is **preallocated, lock-free, and cache-line optimized**.
+ * Designed for **HFT or real-time systems**, where allocation speed and
+ * cache behavior are critical.
+ *
+ * Recycling is LIFO at every level: the magazines, the spill to freeList
+ * (the older magazine goes) and freeList itself all hand out the most
+ * recently freed slot first, the one most likely still in L1/L2.
+ *
+ * The pool trusts the pointers it is given. Build with LOCKFREE_POOL_DEBUG=1
+ * (or Traits::DEBUG_CHECKS) while hunting a double free or a stray write.
+ * 
+ * @tparam T Type of object to allocate
+ * @tparam N Number of objects to preallocate
+ * @tparam Traits Compile-time configuration, see DefaultPoolTraits
+ */
+template<typename T, std::size_t N, typename Traits = DefaultPoolTraits>
+class LockFreeFixedSizeMemoryPool {
+public:
+    using value_type = T;
+    //Dense slot index: half the size of a pointer, see handle_of()
+    using Handle = std::uint32_t;
+    static constexpr Handle NULL_HANDLE = 0xFFFFFFFF;
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // `next` of a node another thread may have popped and be writing to. The
+    // tagged CAS throws the value away in that case, so the race is benign;
+    // keeping it out of TSan leaves every other report meaningful.
+    LOCKFREE_POOL_NO_TSAN static FreeNode* speculativeNext(const FreeNode* node) noexcept {
+        return node->next;
+    }
+
+    static constexpr std::size_t MAGAZINE_SIZE = Traits::MAGAZINE_SIZE;
+    static constexpr std::size_t MAX_THREADS = Traits::MAX_THREADS;
+    static constexpr bool PER_CPU_CACHE = Traits::PER_CPU_CACHE;
+    static constexpr std::size_t MAX_CPUS = Traits::MAX_CPUS;
+    using ExhaustionPolicy = typename Traits::ExhaustionPolicy;
+    using BackingStore = typename Traits::BackingStore;
+    static constexpr bool LAZY_INIT = Traits::LAZY_INIT;
+    static constexpr bool REMOTE_FREE = Traits::REMOTE_FREE;
+    static constexpr bool STATS = Traits::STATS;
+    using Backoff = typename Traits::Backoff;
+    using Ordering = typename Traits::Ordering;
+    static constexpr std::size_t CONTENDED_REFILL_RETRIES = Traits::CONTENDED_REFILL_RETRIES;
+    static constexpr std::size_t TRIM_KEEP_SLABS = Traits::TRIM_KEEP_SLABS;
+    static constexpr std::size_t TRIM_DECAY = Traits::TRIM_DECAY;
+    static constexpr bool INDEXED_FREE_LIST = Traits::INDEXED_FREE_LIST;
+    static constexpr bool PREFETCH_NEXT = Traits::PREFETCH_NEXT;
+    static constexpr bool AWAITABLE = Traits::AWAITABLE;
+    static constexpr bool DEBUG_CHECKS = Traits::DEBUG_CHECKS;
+
+    // ========== Slot Layout ========== //
+    // A free slot holds a FreeNode, a live one holds a T: the slot must fit
+    // and align both, and the stride must keep every slot aligned.
+    static constexpr std::size_t SLOT_MIN_SIZE = std::max(sizeof(T), sizeof(FreeNode));
+    static constexpr std::size_t SLOT_ALIGN = std::max(alignof(T), alignof(FreeNode));
+    static constexpr std::size_t SLOT_SIZE =
+        Traits::SlotLayout::template stride<SLOT_MIN_SIZE, SLOT_ALIGN>();
+    //Slabs start on at least a cache line, so slot 0 honours SLOT_ALIGN too
+    static constexpr std::size_t BUFFER_ALIGN = std::max(CACHE_LINE_SIZE, SLOT_ALIGN);
+
+    static_assert(SLOT_SIZE >= sizeof(T), "Slot stride is smaller than T");
+    static_assert(SLOT_SIZE >= sizeof(FreeNode), "Slot stride cannot hold the free-list link");
+    static_assert(SLOT_SIZE % SLOT_ALIGN == 0, "Slot stride breaks alignof(T) for slots after the first");
+    static_assert(BUFFER_ALIGN <= PAGE_SIZE, "Over-aligned T: alignof(T) exceeds a page");
+
+    // ========== Slab Geometry ========== //
+    // A growable pool reserves MAX_SLABS * SLAB_BYTES of address space up front
+    // and commits one slab at a time. SLAB_BYTES is a power of two, so finding
+    // the slab of any address is a shift and a mask off `buffer`, at any size.
+    static constexpr std::size_t MAX_SLABS = Traits::MAX_SLABS;
+    static constexpr bool GROWABLE = MAX_SLABS > 1;
+    static constexpr std::size_t SLAB_USED_BYTES = N * SLOT_SIZE;
+
+    static constexpr std::size_t slabBytes() noexcept {
+        //Multiple of every common page size and of the backing store's page
+        std::size_t bytes = std::max<std::size_t>(64 * 1024, BackingStore::GRANULARITY);
+        while (bytes < SLAB_USED_BYTES) bytes <<= 1;
+        return bytes;
+    }
+
+    static constexpr std::size_t SLAB_BYTES = GROWABLE ? slabBytes() : SLAB_USED_BYTES;
+    //Whole backing-store pages, so prepare() never runs into the PROT_NONE gap
+    static constexpr std::size_t SLAB_COMMIT_BYTES =
+        (SLAB_USED_BYTES + BackingStore::GRANULARITY - 1) / BackingStore::GRANULARITY * BackingStore::GRANULARITY;
+    static_assert(MAX_SLABS > 0, "A pool needs at least one slab");
+    static_assert(!GROWABLE || LOCKFREE_POOL_HAS_MMAP, "Growable pools need mmap/mprotect");
+    static_assert(!AWAITABLE || LOCKFREE_POOL_HAS_COROUTINES, "Traits::AWAITABLE needs C++20 coroutines");
+    static_assert(MAGAZINE_SIZE > 0, "Magazines must hold at least one node");
+    static_assert(TRIM_DECAY <= 0xFF, "TRIM_DECAY is counted per slab in 8 bits");
+
+    //alignas(CACHE_LINE_SIZE) std::byte buffer[N * SLOT_SIZE];
+    std::byte* buffer; //To create in heap always; slab 0 when growable
+    //Slabs committed so far, published after the slab is readable
+    std::atomic<std::size_t> slabCount{1};
+    //If freeList is accessed heavily, align it to CACHE_LINE_SIZE to avoid contention:
+    //Tagged head: a versioned CAS keeps the pop in allocate() ABA-safe
+    using FreeListHead = std::conditional_t<INDEXED_FREE_LIST, IndexedFreeListHead<FreeNode, SLOT_ALIGN>,
+                                            TaggedFreeListHead<FreeNode>>;
+    static_assert(!INDEXED_FREE_LIST || MAX_SLABS * SLAB_BYTES / SLOT_ALIGN < 0xFFFFFFFF,
+                  "Pool too large for 32-bit free-list indices");
+    alignas(CACHE_LINE_SIZE) FreeListHead freeList;
+    using TaggedPtr = typename FreeListHead::TaggedPtr;
+
+    //Bumped every time allocate() finds the pool empty; kept off the freeList line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> exhaustionCount{0};
+
+    // ========== Lazy Initialization ========== //
+    //Slots [0, watermark) have been handed out at least once (LAZY_INIT only);
+    //everything above it was never touched by the pool
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> watermark{0};
+
+    // ========== Per-Thread Magazines ========== //
+    // Bonwick-style: a thread allocates from and frees into `loaded`; `previous`
+    // is a second full/empty magazine so alternating alloc/free never hits freeList.
+    // With PER_CPU_CACHE the pair belongs to a CPU and its threads take turns.
+    struct Chain {
+        FreeNode* head = nullptr;
+        FreeNode* tail = nullptr;
+        std::size_t count = 0;
+
+        void push(FreeNode* node) noexcept {
+            node->next = head;
+            if (count == 0) tail = node;
+            head = node;
+            ++count;
+        }
+
+        FreeNode* pop() noexcept {
+            FreeNode* node = head;
+            head = node->next;
+            if (--count == 0) {
+                tail = nullptr;
+            } else if constexpr (PREFETCH_NEXT) {
+                //The next pop reads head->next and its caller writes the slot
+                prefetchForWrite(head);
+            }
+            return node;
+        }
+    };
+
+    //One cache line per thread so owners never false-share
+    struct alignas(CACHE_LINE_SIZE) Magazine {
+        Chain loaded;
+        Chain previous;
+        //Last refill hit CONTENDED_REFILL_RETRIES: fetch both magazines next time
+        bool contended = false;
+        //Held while a thread uses this CPU's magazines (PER_CPU_CACHE)
+        std::atomic<bool> busy{false};
+    };
+
+    //PER_CPU_CACHE: indexed by CPU, so the cache no longer grows with threads
+    std::array<Magazine, PER_CPU_CACHE ? MAX_CPUS : MAX_THREADS> magazines{};
+
+    /**
+     * @brief The calling thread's magazines, or nullptr to use freeList directly.
+     *
+     * Per CPU, the magazine is claimed with one exchange on a line only that
+     * CPU's threads touch, and must be handed back with releaseMagazine().
+     * It is busy only if its holder was preempted or migrated mid-operation;
+     * that is rare, so the caller goes to freeList rather than wait.
+     * The exchange is most of the per-CPU fast path (about 12 of 18 extra
+     * ns/op here), but a claim held across calls would stall
+     * flushCpuCaches() and strand the magazines other threads fill.
+     */
+    Magazine* localMagazine() noexcept {
+        if constexpr (PER_CPU_CACHE) {
+            const int cpu = currentCpu();
+            if (cpu < 0 || static_cast<std::size_t>(cpu) >= MAX_CPUS) return nullptr;
+            Magazine& mag = magazines[static_cast<std::size_t>(cpu)];
+            return mag.busy.exchange(true, std::memory_order_acquire) ? nullptr : &mag;
+        } else {
+            const std::size_t index = currentThreadIndex();
+            return index < MAX_THREADS ? &magazines[index] : nullptr;
+        }
+    }
+
+    // Ends a localMagazine() claim; nullptr and per-thread magazines are no-ops
+    static void releaseMagazine(Magazine* mag) noexcept {
+        if constexpr (PER_CPU_CACHE) {
+            if (mag) mag->busy.store(false, std::memory_order_release);
+        }
+        (void)mag;
+    }
+
+    /**
+     * @brief Returns every CPU's magazines to freeList; true if any held a node.
+     *
+     * Per-CPU magazines belong to no thread, so neither thread exit nor a
+     * thread's own flush reaches the ones on other CPUs. Each is claimed in
+     * turn; a busy one is waited for, since its holder is mid-operation.
+     * The caller must not hold a magazine claim itself.
+     */
+    LOCKFREE_POOL_COLD bool flushCpuCaches() noexcept {
+        bool found = false;
+        if constexpr (PER_CPU_CACHE) {
+            for (Magazine& mag : magazines) {
+                for (std::uint32_t spins = 0; mag.busy.exchange(true, std::memory_order_acquire); ++spins) {
+                    if (spins < 64) cpuRelax();
+                    else std::this_thread::yield();
+                }
+                for (Chain* chain : {&mag.loaded, &mag.previous}) {
+                    if (chain->count != 0) {
+                        pushChain(chain->head, chain->tail);
+                        *chain = Chain{};
+                        found = true;
+                    }
+                }
+                releaseMagazine(&mag);
+            }
+        }
+        return found;
+    }
+
+    // ========== Remote-Free Queues ========== //
+    // mimalloc-style: a thread freeing a slot another thread allocated pushes
+    // it onto the owner's MPSC list; the owner takes the whole list with one
+    // exchange when its magazines run dry. Memory flows back to the thread
+    // that allocates it instead of bouncing through freeList.
+    using OwnerId = std::uint16_t;
+    static constexpr OwnerId NO_OWNER = 0xFFFF;
+    static_assert(!REMOTE_FREE || MAX_THREADS < NO_OWNER, "Owner ids are 16-bit");
+    static_assert(!REMOTE_FREE || !PER_CPU_CACHE, "REMOTE_FREE returns slots to their thread; per-CPU caches have none");
+
+    //Separate lines from the magazines: remote threads write these, owners read them
+    struct alignas(CACHE_LINE_SIZE) RemoteQueue {
+        std::atomic<FreeNode*> head{nullptr};
+    };
+
+    std::array<RemoteQueue, REMOTE_FREE ? MAX_THREADS : 0> remoteQueues{};
+    //Owning thread of every slot; written only by the allocating thread and
+    //published to the freeing thread along with the object itself
+    std::unique_ptr<OwnerId[]> slotOwners;
+
+    void pushRemote(std::size_t owner, FreeNode* node) noexcept {
+        std::atomic<FreeNode*>& head = remoteQueues[owner].head;
+        FreeNode* current = head.load(Ordering::PUSH_FAILURE);
+        Backoff backoff;
+        node->next = current;
+        while (!head.compare_exchange_weak(current, node, Ordering::PUSH, Ordering::PUSH_FAILURE)) {
+            if (backoff()) current = head.load(Ordering::PUSH_FAILURE);
+            node->next = current;
+        }
+    }
+
+    /**
+     * @brief Moves everything other threads freed to `mag` back into it.
+     * @return false if the queue was empty.
+     *
+     * Refills `loaded` then `previous`; anything beyond two magazines goes
+     * to freeList as one chain so the cache stays bounded.
+     */
+    bool reclaimRemote(Magazine& mag) noexcept {
+        const std::size_t owner = static_cast<std::size_t>(&mag - magazines.data());
+        FreeNode* node = remoteQueues[owner].head.exchange(nullptr, Ordering::POP);
+        if (!node) return false;
+
+        for (Chain* chain : {&mag.loaded, &mag.previous}) {
+            chain->head = chain->tail = node;
+            chain->count = 1;
+            while (chain->count < MAGAZINE_SIZE && chain->tail->next) {
+                chain->tail = chain->tail->next;
+                ++chain->count;
+            }
+            node = chain->tail->next;
+            chain->tail->next = nullptr;
+            if (!node) return true;
+        }
+
+        FreeNode* last = node;
+        while (last->next) last = last->next;
+        pushChain(node, last);
+        return true;
+    }
+
+    // ========== Thread-Exit Reclamation ========== //
+    ThreadRegistry::Hook registration;
+
+    /**
+     * @brief Returns every node cached for thread `index` to freeList.
+     *
+     * Runs on the thread that owns `index` (explicit flush or thread exit),
+     * so its magazines are never touched concurrently.
+     */
+    void flushThread(std::size_t index) noexcept {
+        //Per-CPU magazines outlive every thread that used them
+        if (PER_CPU_CACHE || index >= MAX_THREADS) return;
+        Magazine& mag = magazines[index];
+        for (Chain* chain : {&mag.loaded, &mag.previous}) {
+            if (chain->count != 0) {
+                pushChain(chain->head, chain->tail);
+                *chain = Chain{};
+            }
+        }
+        if constexpr (REMOTE_FREE) {
+            spliceRemote(index);
+        }
+    }
+
+    // Moves remote queue `index` onto freeList as one chain; false if it was empty
+    bool spliceRemote(std::size_t index) noexcept {
+        FreeNode* node = remoteQueues[index].head.exchange(nullptr, Ordering::POP);
+        if (!node) return false;
+        FreeNode* last = node;
+        while (last->next) last = last->next;
+        pushChain(node, last);
+        return true;
+    }
+
+    /**
+     * @brief Empties every remote queue onto freeList; true if any held a slot.
+     *
+     * Slots keep the owner id of the thread that allocated them after it
+     * exits, so frees that come later land in a queue nobody drains until a
+     * new thread gets that index. A dry pool collects them here instead of
+     * reporting exhaustion with slots stranded. Exchange takes a whole queue
+     * at once, so sweeping a live owner's queue cannot race with it.
+     */
+    LOCKFREE_POOL_COLD bool reclaimAllRemote() noexcept {
+        bool found = false;
+        for (std::size_t index = 0; index < remoteQueues.size(); ++index) {
+            found |= spliceRemote(index);
+        }
+        return found;
+    }
+
+    //Waiters the flush can serve are resumed once the registry lock drops
+    static ThreadRegistry::Deferred* flushExitingThread(void* pool, std::size_t index) noexcept {
+        auto* self = static_cast<LockFreeFixedSizeMemoryPool*>(pool);
+        self->flushThread(index);
+        return self->claimWaiters();
+    }
+
+    // ========== Statistics ========== //
+    // One block per thread index, written only by that thread, so counting is
+    // a plain load+store on a line nobody else writes. Threads past
+    // MAX_THREADS share the extra last block and pay for fetch_add.
+    struct alignas(CACHE_LINE_SIZE) ThreadCounters {
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+        std::atomic<std::uint64_t> cacheHits{0};
+        std::atomic<std::uint64_t> globalPops{0};
+        std::atomic<std::uint64_t> casRetries{0};
+        std::atomic<std::uint64_t> fallbacks{0};
+        std::array<std::atomic<std::uint64_t>, POOL_STATS_RETRY_BUCKETS> retryHistogram{};
+        //allocations - frees not yet folded into inUse
+        std::int64_t unpublished = 0;
+    };
+    using Counter = std::atomic<std::uint64_t> ThreadCounters::*;
+
+    std::array<ThreadCounters, STATS ? MAX_THREADS + 1 : 0> counters{};
+    //Shared, but only touched once per MAGAZINE_SIZE allocations or frees
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> inUse{0};
+    std::atomic<std::int64_t> highWater{0};
+
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n, bool shared) noexcept {
+        if (shared) {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        } else {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+
+    void count(Counter counter, std::uint64_t n = 1) noexcept {
+        if constexpr (STATS) {
+            const std::size_t index = std::min(currentThreadIndex(), MAX_THREADS);
+            bump(counters[index].*counter, n, index == MAX_THREADS);
+        }
+        (void)counter; (void)n;
+    }
+
+    // Records one CAS loop that needed `retries` failed attempts
+    void countRetries(std::size_t retries) noexcept {
+        if constexpr (STATS) {
+            const std::size_t index = std::min(currentThreadIndex(), MAX_THREADS);
+            ThreadCounters& local = counters[index];
+            std::size_t bucket = 0;
+            while (retries >> bucket && bucket + 1 < POOL_STATS_RETRY_BUCKETS) ++bucket;
+            if (retries != 0) bump(local.casRetries, retries, index == MAX_THREADS);
+            bump(local.retryHistogram[bucket], 1, index == MAX_THREADS);
+        }
+        (void)retries;
+    }
+
+    /**
+     * @brief Tracks slots in use for the high-water mark.
+     *
+     * Deltas are batched per thread and folded into the shared inUse count
+     * once they reach MAGAZINE_SIZE, so the recorded peak may trail the true
+     * one by less than MAGAZINE_SIZE per active thread.
+     */
+    void countInUse(std::int64_t delta) noexcept {
+        if constexpr (STATS) {
+            const std::size_t index = std::min(currentThreadIndex(), MAX_THREADS);
+            constexpr auto BATCH = static_cast<std::int64_t>(MAGAZINE_SIZE);
+            if (index < MAX_THREADS) {
+                std::int64_t& pending = counters[index].unpublished;
+                pending += delta;
+                if (pending > -BATCH && pending < BATCH) return;
+                delta = pending;
+                pending = 0;
+            }
+            const std::int64_t now = inUse.fetch_add(delta, std::memory_order_relaxed) + delta;
+            std::int64_t peak = highWater.load(std::memory_order_relaxed);
+            while (now > peak && !highWater.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+            }
+        }
+        (void)delta;
+    }
+
+    // Turns a popped node into the caller's slot: checks its poison and marks
+    // it live (trackHandOut), bumps the STATS counters, and with REMOTE_FREE
+    // records the calling thread as the slot's owner
+    T* handOut(FreeNode* node) noexcept {
+        trackHandOut(node);
+        if constexpr (STATS) {
+            count(&ThreadCounters::allocations);
+            countInUse(1);
+        }
+        if constexpr (REMOTE_FREE) {
+            const std::size_t index = currentThreadIndex();
+            slotOwners[slotIndexOf(node)] = index < MAX_THREADS ? static_cast<OwnerId>(index) : NO_OWNER;
+        }
+        return reinterpret_cast<T*>(node);
+    }
+
+    /**
+     * @brief Sends `node` to its owner's remote queue if another thread owns it.
+     * @return true if the node was queued remotely.
+     */
+    bool freeRemote(FreeNode* node) noexcept {
+        if constexpr (REMOTE_FREE) {
+            const std::size_t owner = slotOwners[slotIndexOf(node)];
+            const std::size_t self = currentThreadIndex();
+            //Late frees from an exiting thread: its old queue was flushed, so free in place
+            if (owner != NO_OWNER && owner != self && self != RELEASED_THREAD_INDEX) {
+                pushRemote(owner, node);
+                return true;
+            }
+        }
+        (void)node;
+        return false;
+    }
+
+    // Byte offset from `buffer`; wraps to a huge value for addresses below it
+    std::uintptr_t offsetOf(const void* p) const noexcept {
+        return reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(buffer);
+    }
+
+    // True if `offset` lies inside a committed slab; O(1) for any slab count.
+    // `&` instead of `&&` keeps it a couple of compares with no extra branch.
+    bool inSlabs(std::uintptr_t offset) const noexcept {
+        if constexpr (!GROWABLE) {
+            return offset < SLAB_USED_BYTES;
+        } else {
+            //Relaxed: a stale count only rejects a slot, and slots are reached
+            //through the free list, which already acquired their contents
+            return (offset / SLAB_BYTES < slabCount.load(std::memory_order_relaxed)) &
+                   (offset % SLAB_BYTES < SLAB_USED_BYTES);
+        }
+    }
+
+    // Global index of the slot at `p`, counting N slots per slab
+    std::size_t slotIndexOf(const void* p) const noexcept {
+        const std::uintptr_t offset = offsetOf(p);
+        if constexpr (!GROWABLE) {
+            return offset / SLOT_SIZE;
+        } else {
+            return offset / SLAB_BYTES * N + offset % SLAB_BYTES / SLOT_SIZE;
+        }
+    }
+
+    // True if `p` points at the start of a slot
+    bool isSlot(const void* p) const noexcept {
+        const std::uintptr_t offset = offsetOf(p);
+        return inSlabs(offset) & (offset % SLAB_BYTES % SLOT_SIZE == 0);
+    }
+
+    /**
+     * @brief Links the N slots of one slab in address order.
+     * @return First slot; the last slot's `next` is nullptr.
+     */
+    static FreeNode* linkSlab(std::byte* slab) noexcept {
+        FreeNode* head = nullptr;
+        //Optimize Free List Initialization**
+        //Reverse-order linking is fine, but forward linking might improve cache locality:
+        //for (std::size_t i = 0; i < N; ++i) {
+            //auto* node = reinterpret_cast<FreeNode*>(&slab[i * SLOT_SIZE]);
+        for (std::size_t i = N; i > 0; --i) {
+            auto* node = reinterpret_cast<FreeNode*>(&slab[(i-1)*SLOT_SIZE]);
+            node->next = head;
+            head = node;
+        }
+        return head;
+    }
+
+#if LOCKFREE_POOL_HAS_MMAP
+    // Makes slab `index` of the reservation readable and writable
+    bool commitSlab(std::size_t index) noexcept {
+        return mprotect(buffer + index * SLAB_BYTES, SLAB_COMMIT_BYTES, PROT_READ | PROT_WRITE) == 0;
+    }
+#endif
+
+    // ========== Occupancy Bitmap ========== //
+    // One bit per slot, set when the slot is handed out and cleared when it
+    // is freed, each with one relaxed atomic RMW (Traits::TRACK_LIVE).
+    // for_each_live() scans it 64 slots per load; the debug checks use it to
+    // catch a second free at the call that makes it, not once two objects
+    // share memory.
+    static constexpr bool TRACK_LIVE = Traits::TRACK_LIVE || DEBUG_CHECKS;
+    static constexpr std::size_t BITMAP_WORDS = (MAX_SLABS * N + 63) / 64;
+    //Bitmap words below this are scanned by one thread (256K slots)
+    static constexpr std::size_t PARALLEL_SCAN_WORDS = 4096;
+    // Lazy and growable pools size the bitmaps for slots that may never be
+    // carved; mapping them leaves the zeroing to the OS, page by page on first
+    // touch, instead of a memset of the whole range in the constructor.
+    static constexpr bool MAP_BITMAPS = LOCKFREE_POOL_HAS_MMAP && (LAZY_INIT || GROWABLE);
+    static constexpr std::size_t BITMAP_BYTES = BITMAP_WORDS * sizeof(std::atomic<std::uint64_t>);
+
+    struct BitmapRelease {
+        void operator()(std::atomic<std::uint64_t>* bits) const noexcept {
+            if constexpr (MAP_BITMAPS) {
+#if LOCKFREE_POOL_HAS_MMAP
+                munmap(bits, BITMAP_BYTES);
+#endif
+            } else {
+                delete[] bits;
+            }
+        }
+    };
+    using Bitmap = std::unique_ptr<std::atomic<std::uint64_t>[], BitmapRelease>;
+
+    // All-clear bitmap of BITMAP_WORDS words
+    static Bitmap makeBitmap() {
+        if constexpr (MAP_BITMAPS) {
+#if LOCKFREE_POOL_HAS_MMAP
+            //Zero-filled anonymous pages are all-clear lock-free atomics
+            void* bits = mmap(nullptr, BITMAP_BYTES, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (bits == MAP_FAILED) throw std::bad_alloc();
+            return Bitmap(static_cast<std::atomic<std::uint64_t>*>(bits));
+#endif
+        }
+        return Bitmap(new std::atomic<std::uint64_t>[BITMAP_WORDS]());
+    }
+
+    Bitmap liveSlots;
+
+    // Sets or clears slot `index`'s bit in `bits`; returns its previous value
+    static bool flipBit(std::atomic<std::uint64_t>* bits, std::size_t index, bool set) noexcept {
+        const std::uint64_t mask = std::uint64_t{1} << (index % 64);
+        std::atomic<std::uint64_t>& word = bits[index / 64];
+        const std::uint64_t old = set ? word.fetch_or(mask, std::memory_order_relaxed)
+                                      : word.fetch_and(~mask, std::memory_order_relaxed);
+        return (old & mask) != 0;
+    }
+
+    // Records a hand-out (`live`) or a free of `slot`; the bit must flip
+    void markLive(const void* slot, bool live) noexcept {
+        if constexpr (TRACK_LIVE) {
+            const bool wasLive = flipBit(liveSlots.get(), slotIndexOf(slot), live);
+            if constexpr (DEBUG_CHECKS) {
+                if (wasLive == live) {
+                    poolMisuse(live ? "slot handed out twice: free list corrupted" : "double free", slot);
+                }
+            }
+            (void)wasLive;
+        }
+        (void)slot; (void)live;
+    }
+
+    // Bitmap words covering the committed slabs
+    std::size_t liveWords() const noexcept {
+        return (capacity() + 63) / 64;
+    }
+
+    // Calls fn(T*) for the live slots of bitmap words [first, last)
+    template<typename Fn>
+    void scanLive(std::size_t first, std::size_t last, Fn& fn) const {
+        for (std::size_t w = first; w < last; ++w) {
+            std::uint64_t bits = liveSlots[w].load(std::memory_order_relaxed);
+            while (bits != 0) {
+                fn(reinterpret_cast<T*>(slotAt(w * 64 + static_cast<std::size_t>(__builtin_ctzll(bits)))));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // ========== Debug Checks ========== //
+    // `poisonedSlots` marks free slots carrying the poison pattern, checked
+    // when they are next handed out; double frees show up in liveSlots.
+    //The link is the free-list's; everything after it may be poisoned
+    static constexpr std::size_t POISON_OFFSET = sizeof(FreeNode);
+    static constexpr std::size_t POISON_BYTES = SLOT_SIZE - POISON_OFFSET;
+
+    Bitmap poisonedSlots;
+
+    // Aborts unless `ptr` is the start of a slot, saying which way it is not
+    void checkSlot(const void* ptr) const noexcept {
+        if (isSlot(ptr)) return;
+        if (inSlabs(offsetOf(ptr))) poolMisuse("deallocate() of a pointer into the middle of a slot", ptr);
+        poolMisuse("deallocate() of a pointer this pool did not allocate", ptr);
+    }
+
+    // Every slot handed out passes here: its poison must be intact
+    void trackHandOut(FreeNode* node) noexcept {
+        if constexpr (DEBUG_CHECKS) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(node);
+            if (flipBit(poisonedSlots.get(), slotIndexOf(node), false)) {
+                unpoisonRegion(bytes + POISON_OFFSET, POISON_BYTES);
+                for (std::size_t i = POISON_OFFSET; i < SLOT_SIZE; ++i) {
+                    if (bytes[i] != POOL_POISON_BYTE) poolMisuse("slot was written after it was freed", node);
+                }
+            }
+        }
+        markLive(node, true);
+    }
+
+    // Every slot freed passes here: foreign, misaligned and double frees abort
+    void trackFree(T* ptr) noexcept {
+        if constexpr (DEBUG_CHECKS) {
+            checkSlot(ptr);
+        }
+        //No heap fallback exists any more, so every pointer must be ours
+        assert(owns(ptr) && "pointer was not allocated from this pool");
+        markLive(ptr, false);
+        if constexpr (DEBUG_CHECKS) {
+            auto* bytes = reinterpret_cast<unsigned char*>(ptr);
+            std::memset(bytes + POISON_OFFSET, POOL_POISON_BYTE, POISON_BYTES);
+            poisonRegion(bytes + POISON_OFFSET, POISON_BYTES);
+            flipBit(poisonedSlots.get(), slotIndexOf(ptr), true);
+        }
+    }
+
+    // Slab `index` lost its contents (trim()): nothing left to check there
+    void forgetPoison(std::size_t index) noexcept {
+        if constexpr (DEBUG_CHECKS) {
+            unpoisonRegion(buffer + index * SLAB_BYTES, SLAB_USED_BYTES);
+            for (std::size_t slot = index * N; slot < (index + 1) * N; ++slot) {
+                flipBit(poisonedSlots.get(), slot, false);
+            }
+        }
+        (void)index;
+    }
+
+    // ========== Safe Memory Reclamation ========== //
+    // Epoch-based. A thread about to read `next` of nodes it does not own
+    // (popChain, the single-node pop) announces the epoch it saw; memory
+    // unlinked from every shared list before epoch E was opened may go back
+    // to the OS once no thread still announces an epoch below E. Readers
+    // never wait; a reclaimer that finds a straggler just tries again later.
+    // Fixed pools never return memory, so there the guards compile away.
+    static constexpr bool SAFE_RECLAIM = GROWABLE && Traits::SAFE_RECLAIM;
+    static constexpr std::uint64_t QUIESCENT = ~std::uint64_t{0};
+
+    struct alignas(CACHE_LINE_SIZE) EpochSlot {
+        std::atomic<std::uint64_t> announced{QUIESCENT};
+    };
+
+    std::array<EpochSlot, SAFE_RECLAIM ? MAX_THREADS : 0> epochSlots{};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> globalEpoch{0};
+    //Threads past MAX_THREADS have no slot: they only count themselves in
+    std::atomic<std::size_t> slotlessReaders{0};
+
+    // Brackets one walk of the shared free list; empty unless SAFE_RECLAIM
+    class ReadGuard {
+    public:
+        explicit ReadGuard(LockFreeFixedSizeMemoryPool& owner) noexcept : pool(owner) {
+            if constexpr (SAFE_RECLAIM) {
+                if (index < MAX_THREADS) {
+                    //Acquire pairs with retireEpoch(): seeing the new epoch means seeing the unlink
+                    pool.epochSlots[index].announced.store(pool.globalEpoch.load(std::memory_order_acquire),
+                                                           std::memory_order_relaxed);
+                } else {
+                    pool.slotlessReaders.fetch_add(1, std::memory_order_relaxed);
+                }
+                //The announcement must be visible before the first read of the list
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        ~ReadGuard() {
+            if constexpr (SAFE_RECLAIM) {
+                if (index < MAX_THREADS) {
+                    pool.epochSlots[index].announced.store(QUIESCENT, std::memory_order_release);
+                } else {
+                    pool.slotlessReaders.fetch_sub(1, std::memory_order_release);
+                }
+            }
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        LockFreeFixedSizeMemoryPool& pool;
+        const std::size_t index = SAFE_RECLAIM ? currentThreadIndex() : 0;
+    };
+
+    /**
+     * @brief Opens a new epoch after memory was unlinked from every shared list.
+     * @return The epoch every reader must have reached before that memory is released.
+     */
+    std::uint64_t retireEpoch() noexcept {
+        return globalEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    /**
+     * @brief True once no reader can still hold a pointer unlinked before `epoch`.
+     *
+     * Never blocks: a reader still inside an older walk makes it return false.
+     */
+    bool quiescentSince(std::uint64_t epoch) const noexcept {
+        if constexpr (SAFE_RECLAIM) {
+            //Pairs with the fence in ReadGuard: either we see its announcement
+            //or it sees our epoch and the unlinked list
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (slotlessReaders.load(std::memory_order_acquire) != 0) return false;
+            for (const EpochSlot& slot : epochSlots) {
+                if (slot.announced.load(std::memory_order_acquire) < epoch) return false;
+            }
+        }
+        (void)epoch;
+        return true;
+    }
+
+    // ========== Slab Trimming ========== //
+    // Changed only under trimMutex; trim() and reviving a slab are the only
+    // writers, both cold. A Released slab is zero-fill memory (MADV_DONTNEED),
+    // safe for stale readers; with SAFE_RECLAIM it is later Protected
+    // (PROT_NONE) once every reader has left the epoch it was released in.
+    enum class SlabState : std::uint8_t { Active, Released, Protected };
+
+    std::mutex trimMutex;
+    std::array<std::atomic<SlabState>, GROWABLE ? MAX_SLABS : 0> slabStates{};
+    //Consecutive trim() calls that found the slab fully free, up to TRIM_DECAY
+    std::array<std::uint8_t, GROWABLE ? MAX_SLABS : 0> slabIdleRounds{};
+    std::array<std::uint64_t, SAFE_RECLAIM ? MAX_SLABS : 0> slabRetiredAt{};
+    //Released + Protected slabs; lets grow() skip the mutex when there are none
+    std::atomic<std::size_t> trimmedSlabs{0};
+    //Bumped as trim() takes the whole free list and again once it is back:
+    //odd while trim() holds it
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> trimGeneration{0};
+
+    // Waits out a running trim(); returns the generation to compare against
+    std::uint64_t awaitTrim() const noexcept {
+        std::uint64_t generation = trimGeneration.load(std::memory_order_acquire);
+        while (generation & 1) {
+            cpuRelax();
+            generation = trimGeneration.load(std::memory_order_acquire);
+        }
+        return generation;
+    }
+
+    // True if a trim() started since `generation`: a pop that came up empty
+    // meanwhile may have seen the detached list rather than a dry pool
+    bool trimOverlapped(std::uint64_t generation) const noexcept {
+        return trimGeneration.load(std::memory_order_acquire) != generation;
+    }
+
+    // Last slot of `slab`, the tail of the chain linkSlab() builds
+    static FreeNode* lastSlot(std::byte* slab) noexcept {
+        return reinterpret_cast<FreeNode*>(slab + (N - 1) * SLOT_SIZE);
+    }
+
+    // Gives the pages of slab `index` back to the OS; false if the OS refused
+    bool releaseSlab(std::size_t index) noexcept {
+#if LOCKFREE_POOL_HAS_MMAP && defined(MADV_DONTNEED)
+        forgetPoison(index);
+        return madvise(buffer + index * SLAB_BYTES, SLAB_COMMIT_BYTES, MADV_DONTNEED) == 0;
+#else
+        (void)index;
+        return false;
+#endif
+    }
+
+    // Protects released slabs whose readers have all moved on (SAFE_RECLAIM)
+    void protectRetiredSlabs() noexcept {
+        if constexpr (SAFE_RECLAIM) {
+            for (std::size_t index = 0; index < slabStates.size(); ++index) {
+                if (slabStates[index].load(std::memory_order_relaxed) == SlabState::Released &&
+                    quiescentSince(slabRetiredAt[index]) &&
+                    mprotect(buffer + index * SLAB_BYTES, SLAB_COMMIT_BYTES, PROT_NONE) == 0) {
+                    slabStates[index].store(SlabState::Protected, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Brings one trimmed slab back and splices its N slots onto freeList.
+     * @return false if no slab is trimmed or the OS refuses to recommit it.
+     */
+    bool reviveSlab() noexcept {
+        if constexpr (GROWABLE) {
+#if LOCKFREE_POOL_HAS_MMAP
+            std::lock_guard<std::mutex> lock(trimMutex);
+            for (std::size_t index = 0; index < slabStates.size(); ++index) {
+                const SlabState state = slabStates[index].load(std::memory_order_relaxed);
+                if (state == SlabState::Active) continue;
+                if (state == SlabState::Protected && !commitSlab(index)) return false;
+                std::byte* slab = buffer + index * SLAB_BYTES;
+                BackingStore::prepare(slab, SLAB_USED_BYTES);
+                //Active before the splice, so walkers accept the new nodes
+                slabStates[index].store(SlabState::Active, std::memory_order_release);
+                slabIdleRounds[index] = 0;
+                pushChain(linkSlab(slab), lastSlot(slab));
+                trimmedSlabs.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+#endif
+        }
+        return false;
+    }
+
+    // False inside a slab trim() released (SAFE_RECLAIM): a walk that got
+    // there through a stale `next` must stop before the slab turns PROT_NONE
+    bool inActiveSlab(const void* p) const noexcept {
+        if constexpr (SAFE_RECLAIM) {
+            return slabStates[offsetOf(p) / SLAB_BYTES].load(std::memory_order_acquire) == SlabState::Active;
+        }
+        (void)p;
+        return true;
+    }
+
+    // ========== Global Free List ========== //
+    /**
+     * @brief Splices a pre-linked chain `first..last` onto freeList with one CAS.
+     */
+    void pushChain(FreeNode* first, FreeNode* last) noexcept {
+        TaggedPtr head = freeList.load(Ordering::PUSH_FAILURE);
+        Backoff backoff;
+        std::size_t retries = 0;
+        last->next = head.ptr;
+        preemptionPoint();
+        while (!freeList.compare_exchange_weak(head, first, Ordering::PUSH, Ordering::PUSH_FAILURE)) {
+            if (backoff()) head = freeList.load(Ordering::PUSH_FAILURE);
+            last->next = head.ptr;
+            ++retries;
+        }
+        countRetries(retries);
+    }
+
+    /**
+     * @brief Detaches up to `max` nodes from freeList with one successful CAS.
+     *
+     * Walking past the head reads `next` of nodes another thread may have
+     * popped already; every hop is checked to be a slot of this pool, and the
+     * tagged CAS rejects the chain unless the list was untouched meanwhile.
+     * With SAFE_RECLAIM the walk runs under a ReadGuard, so a slab being
+     * released cannot be unmapped beneath it.
+     * @param retriesOut If set, receives the number of failed attempts
+     */
+    Chain popChain(std::size_t max, std::size_t* retriesOut = nullptr) noexcept {
+        const ReadGuard guard(*this);
+        TaggedPtr head = freeList.load(Ordering::HEAD_LOAD);
+        Backoff backoff;
+        for (std::size_t retries = 0;; ++retries) {
+            if (retriesOut) *retriesOut = retries;
+            if (!head.ptr) {
+                countRetries(retries);
+                return Chain{};
+            }
+            FreeNode* last = head.ptr;
+            FreeNode* rest = speculativeNext(last);
+            std::size_t count = 1;
+            while (rest && count < max && isSlot(rest) && inActiveSlab(rest)) {
+                last = rest;
+                rest = speculativeNext(rest);
+                ++count;
+            }
+            if (rest && count < max) {
+                //Walked into a node that was reused under us: take a fresh snapshot
+                backoff();
+                head = freeList.load(Ordering::HEAD_LOAD);
+                continue;
+            }
+            preemptionPoint();
+            if (freeList.compare_exchange_weak(head, rest, Ordering::POP, Ordering::POP_FAILURE)) {
+                Chain chain;
+                chain.head = head.ptr;
+                chain.tail = last;
+                chain.count = count;
+                countRetries(retries);
+                this->count(&ThreadCounters::globalPops);
+                return chain;
+            }
+            if (backoff()) head = freeList.load(Ordering::HEAD_LOAD);
+        }
+    }
+
+    /**
+     * @brief One slot from this thread's magazines or the shared list, or nullptr.
+     */
+    FreeNode* popNode() noexcept {
+        if (Magazine* mag = localMagazine()) {
+            if (mag->loaded.count != 0) {
+                count(&ThreadCounters::cacheHits);
+            } else {
+                if (mag->previous.count != 0) {
+                    std::swap(mag->loaded, mag->previous);
+                } else if (!REMOTE_FREE || !reclaimRemote(*mag)) {
+                    refill(*mag);
+                }
+            }
+            FreeNode* node = mag->loaded.count != 0 ? mag->loaded.pop() : nullptr;
+            releaseMagazine(mag);
+            return node;
+        }
+
+        //Tag changes on every push/pop, so a stale `next` can never be installed
+        const ReadGuard guard(*this);
+        TaggedPtr head = freeList.load(Ordering::HEAD_LOAD);
+        Backoff backoff;
+        for (std::size_t retries = 0; head.ptr; ++retries) {
+            FreeNode* next = speculativeNext(head.ptr);
+            preemptionPoint();
+            if (freeList.compare_exchange_weak(head, next, Ordering::POP, Ordering::POP_FAILURE)) {
+                countRetries(retries);
+                count(&ThreadCounters::globalPops);
+                if constexpr (PREFETCH_NEXT) {
+                    if (next) prefetchForWrite(next);
+                }
+                return head.ptr;
+            }
+            if (backoff()) head = freeList.load(Ordering::HEAD_LOAD);
+        }
+        if constexpr (LAZY_INIT) {
+            return carveChain(1).head;
+        }
+        return nullptr;
+    }
+
+    // Address of global slot `index`, counting N slots per slab
+    FreeNode* slotAt(std::size_t index) const noexcept {
+        if constexpr (!GROWABLE) {
+            return reinterpret_cast<FreeNode*>(buffer + index * SLOT_SIZE);
+        } else {
+            return reinterpret_cast<FreeNode*>(buffer + index / N * SLAB_BYTES + index % N * SLOT_SIZE);
+        }
+    }
+
+    /**
+     * @brief Claims up to `max` never-used slots above the watermark (LAZY_INIT).
+     *
+     * One CAS on the watermark; only the claimed slots are written, so pages
+     * past the watermark stay untouched until a thread actually needs them.
+     */
+    Chain carveChain(std::size_t max) noexcept {
+        Chain chain;
+        if constexpr (LAZY_INIT) {
+            const std::size_t limit = capacity();
+            std::size_t first = watermark.load(std::memory_order_relaxed);
+            std::size_t take = 0;
+            Backoff backoff;
+            for (;;) {
+                if (first >= limit) return chain;
+                take = std::min(max, limit - first);
+                if (watermark.compare_exchange_weak(first, first + take, std::memory_order_relaxed,
+                                                    std::memory_order_relaxed)) {
+                    break;
+                }
+                if (backoff()) first = watermark.load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = first + take; i > first; --i) {
+                chain.push(slotAt(i - 1));
+            }
+        }
+        (void)max;
+        return chain;
+    }
+
+    /**
+     * @brief Up to `max` nodes: recycled ones from freeList, topped up with fresh ones.
+     *
+     * Recycled nodes go first: they are already resident and cache-warm, and
+     * untouched memory stays untouched for as long as possible.
+     */
+    Chain acquireChain(std::size_t max, std::size_t* retriesOut = nullptr) noexcept {
+        Chain chain = popChain(max, retriesOut);
+        if constexpr (LAZY_INIT) {
+            if (chain.count < max) {
+                Chain fresh = carveChain(max - chain.count);
+                if (fresh.count != 0) {
+                    fresh.tail->next = chain.head;
+                    fresh.count += chain.count;
+                    if (chain.count != 0) fresh.tail = chain.tail;
+                    chain = fresh;
+                }
+            }
+        }
+        return chain;
+    }
+
+    /**
+     * @brief Refills an empty magazine pair from the shared list.
+     *
+     * Normally one magazine's worth. A thread whose last refill needed
+     * CONTENDED_REFILL_RETRIES failed attempts takes two in one batch and
+     * splits them into `loaded` and `previous`, halving its trips to the
+     * contended head while its cache stays bounded by two magazines.
+     */
+    void refill(Magazine& mag) noexcept {
+        if constexpr (CONTENDED_REFILL_RETRIES == 0) {
+            mag.loaded = acquireChain(MAGAZINE_SIZE);
+        } else {
+            std::size_t retries = 0;
+            Chain chain = acquireChain(mag.contended ? 2 * MAGAZINE_SIZE : MAGAZINE_SIZE, &retries);
+            mag.contended = retries >= CONTENDED_REFILL_RETRIES;
+            if (chain.count > MAGAZINE_SIZE) {
+                FreeNode* cut = chain.head;
+                for (std::size_t i = 1; i < MAGAZINE_SIZE; ++i) cut = cut->next;
+                mag.previous.head = cut->next;
+                mag.previous.tail = chain.tail;
+                mag.previous.count = chain.count - MAGAZINE_SIZE;
+                chain.tail = cut;
+                chain.count = MAGAZINE_SIZE;
+            }
+            mag.loaded = chain;
+        }
+    }
+
+    /**
+     * @brief Looks for a slot everywhere a plain pop does not: behind a
+     *        running trim(), in every remote queue, on every CPU.
+     * @param swept Set if slots were moved onto the free list on the way.
+     *
+     * Takes no waiter lock, so park() runs it under its own.
+     */
+    LOCKFREE_POOL_COLD FreeNode* reclaimNode(bool& swept) noexcept {
+        if constexpr (GROWABLE) {
+            //trim() holds the whole list for a moment; not a real exhaustion.
+            //Only a miss no trim() overlapped counts as one.
+            for (;;) {
+                const std::uint64_t generation = awaitTrim();
+                if (FreeNode* node = popNode()) return node;
+                if (!trimOverlapped(generation)) break;
+            }
+        }
+        if constexpr (REMOTE_FREE) {
+            if (reclaimAllRemote()) {
+                swept = true;
+                if (FreeNode* node = popNode()) return node;
+            }
+        }
+        if constexpr (PER_CPU_CACHE) {
+            //Slots cached on CPUs this thread is not running on
+            if (flushCpuCaches()) {
+                swept = true;
+                if (FreeNode* node = popNode()) return node;
+            }
+        }
+        return nullptr;
+    }
+
+    // Slow path, kept out of line so allocate() stays a few instructions
+    LOCKFREE_POOL_COLD T* allocateExhausted() noexcept {
+        bool swept = false;
+        FreeNode* node = reclaimNode(swept);
+        //A sweep may have freed more than this one slot
+        if (swept) serveWaiters();
+        if (node) return handOut(node);
+        exhaustionCount.fetch_add(1, std::memory_order_relaxed);
+        count(&ThreadCounters::fallbacks);
+        return static_cast<T*>(ExhaustionPolicy::onExhausted(
+            *this, [this]() noexcept -> void* {
+                FreeNode* node = popNode();
+                return node ? handOut(node) : nullptr;
+            }));
+    }
+
+    // ========== Awaitable Allocation ========== //
+    // Coroutines that find the pool dry park in a FIFO instead of polling;
+    // whatever puts slots back (deallocate(), a cache flush, thread exit,
+    // trim(), grow(), a reclaim sweep) gives them to the oldest ones and
+    // resumes them. Parking only happens on exhaustion, so the FIFO sits
+    // behind a mutex like the other cold paths; the free path pays a fence
+    // and one load of `waiterCount`.
+#if LOCKFREE_POOL_HAS_COROUTINES
+public:
+    /**
+     * @brief What async_allocate() returns; lives in the awaiting coroutine's frame.
+     */
+    class AllocateAwaiter {
+    public:
+        bool await_ready() noexcept {
+            slot = pool.tryAllocate();
+            return slot != nullptr;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            waiting = handle;
+            return pool.park(*this);
+        }
+
+        T* await_resume() const noexcept {
+            return slot;
+        }
+
+    private:
+        friend class LockFreeFixedSizeMemoryPool;
+        explicit AllocateAwaiter(LockFreeFixedSizeMemoryPool& owner) noexcept : pool(owner) {
+            wakeup.run = [](void* self) noexcept { static_cast<AllocateAwaiter*>(self)->waiting.resume(); };
+            wakeup.context = this;
+        }
+
+        LockFreeFixedSizeMemoryPool& pool;
+        std::coroutine_handle<> waiting;
+        T* slot = nullptr;
+        AllocateAwaiter* next = nullptr;
+        //Links served waiters until they are resumed
+        ThreadRegistry::Deferred wakeup;
+    };
+
+private:
+    std::mutex waiterMutex;
+    AllocateAwaiter* oldestWaiter = nullptr;
+    AllocateAwaiter* newestWaiter = nullptr;
+    //Parked awaiters plus any about to park; read by every deallocate()
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> waiterCount{0};
+
+    // allocate() minus ExhaustionPolicy: growable pools grow, then nullptr
+    T* tryAllocate() noexcept {
+        FreeNode* node = popNode();
+        if constexpr (GROWABLE) {
+            while (!node && grow()) node = popNode();
+        }
+        return node ? handOut(node) : nullptr;
+    }
+
+    /**
+     * @brief Queues `waiter` unless a slot turned up meanwhile.
+     * @return false if `waiter` got a slot and must not suspend.
+     *
+     * The count goes up before the last attempt, and whatever returns slots
+     * checks it after its push, each behind a seq_cst fence: either the
+     * attempt finds that slot or the other side sees the count and serves
+     * the queue once this lock drops. The last attempt sweeps like
+     * allocate()'s slow path. Once queued, the coroutine may be resumed on
+     * another thread before this returns: nothing here touches `waiter`
+     * after the unlock.
+     */
+    bool park(AllocateAwaiter& waiter) noexcept {
+        bool swept = false;
+        {
+            std::lock_guard<std::mutex> lock(waiterMutex);
+            waiterCount.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            FreeNode* node = popNode();
+            if (!node) node = reclaimNode(swept);
+            if (!node) {
+                exhaustionCount.fetch_add(1, std::memory_order_relaxed);
+                waiter.next = nullptr;
+                if (newestWaiter) {
+                    newestWaiter->next = &waiter;
+                } else {
+                    oldestWaiter = &waiter;
+                }
+                newestWaiter = &waiter;
+                return true;
+            }
+            waiterCount.fetch_sub(1, std::memory_order_relaxed);
+            waiter.slot = handOut(node);
+        }
+        //The sweep may have found slots for waiters queued before this one
+        if (swept) serveWaiters();
+        return false;
+    }
+#endif
+
+    /**
+     * @brief Hands free slots to parked async_allocate() callers, oldest first.
+     * @return The served waiters, for ThreadRegistry::runDeferred() to resume.
+     *
+     * Called after anything puts slots back. Pops through this thread's
+     * magazine before the shared list, so a free that landed in the cache
+     * still reaches a waiter. Nobody is resumed under the lock.
+     */
+    ThreadRegistry::Deferred* claimWaiters() noexcept {
+        ThreadRegistry::Deferred* served = nullptr;
+#if LOCKFREE_POOL_HAS_COROUTINES
+        if constexpr (AWAITABLE) {
+            //Pairs with the fence in park(): orders our push before this load
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiterCount.load(std::memory_order_relaxed) == 0) return nullptr;
+            ThreadRegistry::Deferred** tail = &served;
+            std::lock_guard<std::mutex> lock(waiterMutex);
+            while (AllocateAwaiter* waiter = oldestWaiter) {
+                FreeNode* node = popNode();
+                if (!node) break;
+                oldestWaiter = waiter->next;
+                if (!oldestWaiter) newestWaiter = nullptr;
+                waiterCount.fetch_sub(1, std::memory_order_relaxed);
+                waiter->slot = handOut(node);
+                waiter->wakeup.next = nullptr;
+                *tail = &waiter->wakeup;
+                tail = &waiter->wakeup.next;
+            }
+        }
+#endif
+        return served;
+    }
+
+    // claimWaiters() and resume them on this thread, with no lock or magazine held
+    void serveWaiters() noexcept {
+        ThreadRegistry::runDeferred(claimWaiters());
+    }
+
+
+public:
+    /**
+     * @param numaNode Place every slab on this NUMA node (NO_NUMA_NODE = first touch)
+     * @throws std::bad_alloc if the backing memory cannot be obtained
+     */
+      explicit LockFreeFixedSizeMemoryPool(int numaNode = NO_NUMA_NODE) {
+         if constexpr (REMOTE_FREE) {
+            //Default-initialised: pages are only touched as slots are handed out
+            slotOwners.reset(new OwnerId[MAX_SLABS * N]);
+         }
+         if constexpr (TRACK_LIVE) {
+            liveSlots = makeBitmap();
+         }
+         if constexpr (DEBUG_CHECKS) {
+            poisonedSlots = makeBitmap();
+         }
+         if constexpr (GROWABLE) {
+#if LOCKFREE_POOL_HAS_MMAP
+            //Reserve address space only; slabs are committed on demand
+            buffer = static_cast<std::byte*>(mapAligned(MAX_SLABS * SLAB_BYTES, BackingStore::GRANULARITY,
+                                                        PROT_NONE, MAP_NORESERVE));
+            //Policy set on the whole reservation applies to slabs committed later
+            if (buffer && numaNode != NO_NUMA_NODE) {
+                bindToNumaNode(buffer, MAX_SLABS * SLAB_BYTES, numaNode);
+            }
+            if (buffer && !commitSlab(0)) {
+                munmap(buffer, MAX_SLABS * SLAB_BYTES);
+                buffer = nullptr;
+            }
+#endif
+         } else {
+            //aligned_alloc() to ensure cacheline alignment; page-aligned when
+            //binding, so the NUMA policy covers the buffer and nothing else
+            const std::size_t alignment = numaNode != NO_NUMA_NODE ? PAGE_SIZE : BUFFER_ALIGN;
+            buffer = static_cast<std::byte*>(BackingStore::allocate(SLAB_USED_BYTES, alignment));
+            if (buffer && numaNode != NO_NUMA_NODE) {
+                bindToNumaNode(buffer, SLAB_USED_BYTES, numaNode);
+            }
+         }
+         if (!buffer) {
+            throw std::bad_alloc();
+         }
+        if constexpr (INDEXED_FREE_LIST) {
+            freeList.rebase(buffer);
+        }
+
+        //First touch happens here, after any NUMA policy is in place
+        BackingStore::prepare(buffer, SLAB_USED_BYTES);
+        if constexpr (!LAZY_INIT) {
+            freeList.store(linkSlab(buffer), std::memory_order_release);
+        }
+
+        //Last: once attached, exiting threads flush their caches into this pool
+        registration.flush = &flushExitingThread;
+        registration.pool = this;
+        ThreadRegistry::instance().attach(registration);
+    }
+
+    /**
+     * @brief Returns the calling thread's cached nodes to the shared free list.
+     *
+     * Happens automatically at thread exit; call it before a thread parks
+     * for a long time so other threads can use its share of the pool.
+     * With PER_CPU_CACHE the magazines belong to no thread: this is
+     * flush_cpu_caches().
+     */
+    void flush_thread_cache() noexcept {
+        if constexpr (PER_CPU_CACHE) {
+            flushCpuCaches();
+        } else {
+            flushThread(currentThreadIndex());
+        }
+        serveWaiters();
+    }
+
+    /**
+     * @brief Returns every CPU's cached nodes to the shared free list (PER_CPU_CACHE).
+     *
+     * allocate() does this by itself before reporting exhaustion, and trim()
+     * before counting free slots; call it to see an exact free list, e.g.
+     * before a full drain. Waits for each CPU's magazines to be put down.
+     */
+    void flush_cpu_caches() noexcept {
+        static_assert(PER_CPU_CACHE, "flush_cpu_caches() needs Traits::PER_CPU_CACHE");
+        flushCpuCaches();
+        serveWaiters();
+    }
+
+    /**
+     * @brief Commits the next slab and splices its N slots onto the free list.
+     * @return false once MAX_SLABS slabs exist or the OS refuses the commit;
+     *         true if capacity was added, by this call or a concurrent one.
+     *
+     * Lock-free: racing growers may all commit the same slab (idempotent),
+     * but only the one whose CAS publishes it links and splices its slots.
+     * LAZY_INIT pools skip the linking; publishing raises the carve limit.
+     * Slabs released by trim() are brought back first, under trim()'s lock.
+     */
+    bool grow() noexcept {
+        if constexpr (!GROWABLE) {
+            return false;
+        } else {
+#if LOCKFREE_POOL_HAS_MMAP
+            if (trimmedSlabs.load(std::memory_order_acquire) != 0 && reviveSlab()) {
+                serveWaiters();
+                return true;
+            }
+            std::size_t index = slabCount.load(std::memory_order_acquire);
+            if (index >= MAX_SLABS || !commitSlab(index)) {
+                return false;
+            }
+            //Release publishes the commit; the loser just retries its pop
+            if (slabCount.compare_exchange_strong(index, index + 1, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+                std::byte* slab = buffer + index * SLAB_BYTES;
+                BackingStore::prepare(slab, SLAB_USED_BYTES);
+                //Lazy pools just raised the carve limit by publishing slabCount
+                if constexpr (!LAZY_INIT) {
+                    pushChain(linkSlab(slab), lastSlot(slab));
+                }
+                serveWaiters();
+            }
+            return true;
+#else
+            return false;
+#endif
+        }
+    }
+
+    /**
+     * @brief Returns slabs that stayed fully free to the OS.
+     * @return Number of slabs released by this call.
+     *
+     * A slab is released once TRIM_DECAY consecutive calls found all N of
+     * its slots on the shared free list, never leaving fewer than
+     * TRIM_KEEP_SLABS resident. Call it periodically (e.g. from a
+     * housekeeping thread) for time-based decay; slots parked in per-thread
+     * magazines keep their slab resident, see flush_thread_cache(), while
+     * per-CPU magazines are flushed first.
+     *
+     * Pages go back with MADV_DONTNEED; with SAFE_RECLAIM a later call also
+     * makes them PROT_NONE once no thread can still be reading them. The
+     * slab keeps its address range and grow() revives it before committing
+     * a new one, so GrowOnExhaustion pools get the capacity back on demand.
+     * The free list is detached while it is sorted; a thread that runs dry
+     * meanwhile waits for trim() in its slow path instead of seeing exhaustion.
+     */
+    std::size_t trim() noexcept {
+        static_assert(GROWABLE, "trim() needs a growable pool (Traits::MAX_SLABS > 1)");
+        static_assert(!LAZY_INIT, "trim() needs eagerly linked slabs (Traits::LAZY_INIT = false)");
+        std::unique_lock<std::mutex> lock(trimMutex);
+        protectRetiredSlabs();
+        flushCpuCaches();
+
+        //Take the whole list; pushers keep working on the empty head meanwhile.
+        //acq_rel: a pop that sees the detached head also sees the odd generation
+        trimGeneration.fetch_add(1, std::memory_order_relaxed);
+        TaggedPtr head = freeList.load(Ordering::HEAD_LOAD);
+        while (head.ptr && !freeList.compare_exchange_weak(head, nullptr, std::memory_order_acq_rel,
+                                                           Ordering::POP_FAILURE)) {
+        }
+
+        std::array<std::size_t, MAX_SLABS> freeSlots{};
+        for (FreeNode* node = head.ptr; node; node = node->next) {
+            ++freeSlots[offsetOf(node) / SLAB_BYTES];
+        }
+
+        const std::size_t slabs = slab_count();
+        std::size_t resident = slabs - trimmedSlabs.load(std::memory_order_relaxed);
+        std::array<bool, MAX_SLABS> release{};
+        for (std::size_t index = slabs; index-- > 0;) {
+            if (slabStates[index].load(std::memory_order_relaxed) != SlabState::Active) continue;
+            if (freeSlots[index] != N) {
+                slabIdleRounds[index] = 0;
+                continue;
+            }
+            if (slabIdleRounds[index] < TRIM_DECAY) ++slabIdleRounds[index];
+            if (slabIdleRounds[index] >= TRIM_DECAY && resident > TRIM_KEEP_SLABS) {
+                release[index] = true;
+                --resident;
+            }
+        }
+
+        //Relink everything else, keeping the list order
+        FreeNode* first = nullptr;
+        FreeNode* last = nullptr;
+        for (FreeNode* node = head.ptr; node;) {
+            FreeNode* next = node->next;
+            if (!release[offsetOf(node) / SLAB_BYTES]) {
+                if (last) last->next = node;
+                else first = node;
+                last = node;
+            }
+            node = next;
+        }
+        if (first) pushChain(first, last);
+        trimGeneration.fetch_add(1, std::memory_order_release);
+
+        std::size_t released = 0;
+        for (std::size_t index = 0; index < slabs; ++index) {
+            if (!release[index]) continue;
+            if (!releaseSlab(index)) {
+                std::byte* slab = buffer + index * SLAB_BYTES;
+                pushChain(linkSlab(slab), lastSlot(slab));
+                continue;
+            }
+            //Released before the epoch opens: later walks refuse the slab
+            slabStates[index].store(SlabState::Released, std::memory_order_release);
+            if constexpr (SAFE_RECLAIM) slabRetiredAt[index] = retireEpoch();
+            trimmedSlabs.fetch_add(1, std::memory_order_release);
+            ++released;
+        }
+        //Relinked and flushed slots may be what a waiter parked for
+        lock.unlock();
+        serveWaiters();
+        return released;
+    }
+
+    /**
+     * @brief Slabs whose memory trim() has handed back to the OS.
+     */
+    std::size_t trimmed_slabs() const noexcept {
+        return GROWABLE ? trimmedSlabs.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief Slabs committed so far (1 for a fixed pool), trimmed ones included.
+     */
+    std::size_t slab_count() const noexcept {
+        return slabCount.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief True if `ptr` is the start of a slot in one of this pool's slabs.
+     *
+     * A subtract, a shift/mask and two compares against pool-local fields,
+     * whatever the slab count; never dereferences `ptr`.
+     */
+    bool owns(const T* ptr) const noexcept {
+        return isSlot(ptr);
+    }
+
+    static constexpr std::size_t max_slabs() noexcept {
+        return MAX_SLABS;
+    }
+
+    // ========== Compact Handles ========== //
+    /**
+     * @brief 32-bit name of the slot at `ptr`: its index, counting N per slab.
+     *
+     * Indices are dense (below max_slabs() * N), so a pool of at most 2^24
+     * slots also fits them in three bytes. nullptr maps to NULL_HANDLE.
+     */
+    Handle handle_of(const T* ptr) const noexcept {
+        static_assert(MAX_SLABS * N < NULL_HANDLE, "Pool too large for 32-bit handles");
+        if (!ptr) return NULL_HANDLE;
+        assert(owns(ptr) && "pointer was not allocated from this pool");
+        return static_cast<Handle>(slotIndexOf(ptr));
+    }
+
+    /**
+     * @brief The slot named by `handle`: arithmetic off the base, no lookup.
+     */
+    T* get(Handle handle) const noexcept {
+        if (handle == NULL_HANDLE) return nullptr;
+        assert(handle < capacity() && "handle out of range");
+        return reinterpret_cast<T*>(slotAt(handle));
+    }
+
+    /**
+     * @brief allocate(), returning a handle; NULL_HANDLE when exhausted.
+     */
+    Handle allocate_handle() noexcept {
+        return handle_of(allocate());
+    }
+
+    /**
+     * @brief deallocate() by handle; NULL_HANDLE is a no-op.
+     */
+    void deallocate_handle(Handle handle) noexcept {
+        deallocate(get(handle));
+    }
+
+    // ========== Live-Object Iteration ========== //
+    /**
+     * @brief Calls `fn(T*)` for every slot currently handed out (Traits::TRACK_LIVE).
+     *
+     * Walks the occupancy bitmap in address order, one load per 64 slots and
+     * one tzcnt per live slot, so empty stretches cost next to nothing and
+     * the objects themselves stream in prefetcher-friendly order. Meant for
+     * a quiescent pool (snapshot, reconciliation, GC sweep): a slot allocated
+     * or freed during the scan may or may not be visited, and an object still
+     * being constructed may be seen half-written.
+     */
+    template<typename Fn>
+    void for_each_live(Fn&& fn) const {
+        static_assert(TRACK_LIVE, "Enable Traits::TRACK_LIVE to iterate live objects");
+        scanLive(0, liveWords(), fn);
+    }
+
+    /**
+     * @brief for_each_live() with the bitmap split across `threads` threads.
+     *
+     * `fn` runs concurrently on disjoint slots and must not throw. Below
+     * 256K slots, or if no thread can be spawned, the calling thread scans
+     * alone.
+     */
+    template<typename Fn>
+    void for_each_live_parallel(Fn&& fn, unsigned threads = std::thread::hardware_concurrency()) const {
+        static_assert(TRACK_LIVE, "Enable Traits::TRACK_LIVE to iterate live objects");
+        const std::size_t words = liveWords();
+        auto scan = [this, &fn](std::size_t first, std::size_t last) { scanLive(first, last, fn); };
+        if (threads <= 1 || words <= PARALLEL_SCAN_WORDS) {
+            scan(0, words);
+            return;
+        }
+
+        //Whole cache lines of bitmap per worker
+        const std::size_t chunk = (words / threads + 7) / 8 * 8;
+        std::vector<std::thread> workers;
+        try {
+            for (std::size_t first = chunk; first < words; first += chunk) {
+                workers.emplace_back(scan, first, std::min(first + chunk, words));
+            }
+        } catch (...) {
+            //Could not spawn: the remaining chunks are scanned below
+        }
+        const std::size_t covered = chunk * (workers.size() + 1);
+        scan(0, chunk);
+        if (covered < words) scan(covered, words);
+        for (auto& worker : workers) worker.join();
+    }
+
+    /**
+     * @brief Slots currently handed out, by popcount over the bitmap (Traits::TRACK_LIVE).
+     */
+    std::size_t live_count() const noexcept {
+        static_assert(TRACK_LIVE, "Enable Traits::TRACK_LIVE to count live objects");
+        std::size_t live = 0;
+        for (std::size_t w = 0, words = liveWords(); w < words; ++w) {
+            live += static_cast<std::size_t>(__builtin_popcountll(liveSlots[w].load(std::memory_order_relaxed)));
+        }
+        return live;
+    }
+
+    /**
+     * @brief Bytes between consecutive slots, as chosen by Traits::SlotLayout.
+     */
+    static constexpr std::size_t slot_size() noexcept {
+        return SLOT_SIZE;
+    }
+
+    /**
+     * @brief Alignment every slot is guaranteed to have.
+     */
+    static constexpr std::size_t slot_alignment() noexcept {
+        return SLOT_ALIGN;
+    }
+
+    /**
+     * @brief Slots in committed slabs (N * slab_count()), trimmed slabs included.
+     */
+    std::size_t capacity() const noexcept {
+        return N * slab_count();
+    }
+
+    /**
+     * @brief Allocates memory for one object.
+     * @return Pointer to uninitialized memory, or whatever ExhaustionPolicy
+     *         yields (nullptr by default) when the pool is empty.
+     * 
+     * Pops from this thread's **magazine**; an empty magazine is refilled
+     * with a batch of up to MAGAZINE_SIZE nodes in a single CAS.
+     * Never touches the heap or any I/O stream.
+     */
+    T* allocate() noexcept {
+        if (FreeNode* node = popNode()) {
+            return handOut(node);
+        }
+        return allocateExhausted();
+    }
+
+#if LOCKFREE_POOL_HAS_COROUTINES
+    /**
+     * @brief `T* slot = co_await pool.async_allocate();` (Traits::AWAITABLE, C++20).
+     *
+     * Never nullptr and never runs ExhaustionPolicy. Before parking, the
+     * coroutine sweeps the remote queues and per-CPU caches as allocate()
+     * does; while the pool is still dry (a growable one after growing to
+     * MAX_SLABS), it is parked. The next thread that puts slots back hands
+     * them out oldest waiter first and resumes the waiters on itself. That
+     * happens inside deallocate(), the flushes, trim(), grow(), or a
+     * thread's exit after its other thread_locals are gone. Slots cached in
+     * other live threads' per-thread magazines are not pulled back; they
+     * reach a waiter when their thread frees, flushes or exits.
+     */
+    AllocateAwaiter async_allocate() noexcept {
+        static_assert(AWAITABLE, "Enable Traits::AWAITABLE to await allocations");
+        return AllocateAwaiter(*this);
+    }
+#endif
+
+    /**
+     * @brief Number of times the pool was found empty (relaxed, for scraping).
+     */
+    std::uint64_t exhaustion_count() const noexcept {
+        return exhaustionCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sums every thread's counters (Traits::STATS only).
+     *
+     * Relaxed reads while allocation goes on, so counters from different
+     * threads may be a few operations apart; good enough to size N and
+     * MAGAZINE_SIZE, not an exact census.
+     */
+    PoolStats snapshot() const noexcept {
+        static_assert(STATS, "Enable Traits::STATS to collect pool statistics");
+        PoolStats stats;
+        for (const ThreadCounters& local : counters) {
+            stats.allocations += local.allocations.load(std::memory_order_relaxed);
+            stats.frees += local.frees.load(std::memory_order_relaxed);
+            stats.cache_hits += local.cacheHits.load(std::memory_order_relaxed);
+            stats.global_pops += local.globalPops.load(std::memory_order_relaxed);
+            stats.cas_retries += local.casRetries.load(std::memory_order_relaxed);
+            stats.fallbacks += local.fallbacks.load(std::memory_order_relaxed);
+            for (std::size_t b = 0; b < POOL_STATS_RETRY_BUCKETS; ++b) {
+                stats.cas_retry_histogram[b] += local.retryHistogram[b].load(std::memory_order_relaxed);
+            }
+        }
+        stats.in_use = stats.allocations > stats.frees ? stats.allocations - stats.frees : 0;
+        const std::int64_t peak = highWater.load(std::memory_order_relaxed);
+        stats.high_water_mark = std::max(static_cast<std::uint64_t>(std::max<std::int64_t>(peak, 0)), stats.in_use);
+        return stats;
+    }
+
+    /**
+     * @brief Deallocates memory, returning it back to the pool.
+     * @param ptr Pointer to memory previously allocated by `allocate()`.
+     * 
+     * Pushes onto this thread's magazine. When both magazines are full, one
+     * full magazine is spliced onto the shared free list with a single CAS,
+     * so a thread that only frees never hoards more than 2 * MAGAZINE_SIZE nodes.
+     */
+    void deallocate(T* ptr) noexcept {
+        if (!ptr) return;
+        trackFree(ptr);
+
+        if constexpr (STATS) {
+            count(&ThreadCounters::frees);
+            countInUse(-1);
+        }
+
+        auto* node = reinterpret_cast<FreeNode*>(ptr);
+        if (!freeRemote(node)) {
+            Magazine* mag = localMagazine();
+            if (!mag) {
+                pushChain(node, node);
+            } else {
+                if (mag->loaded.count == MAGAZINE_SIZE) {
+                    if (mag->previous.count == MAGAZINE_SIZE) {
+                        //Spill half of this thread's cache: one pre-linked magazine, one CAS
+                        pushChain(mag->previous.head, mag->previous.tail);
+                        mag->previous = Chain{};
+                    }
+                    std::swap(mag->loaded, mag->previous);
+                }
+                mag->loaded.push(node);
+                releaseMagazine(mag);
+            }
+        }
+        serveWaiters();
+    }
+
+    /**
+     * @brief Allocates a slot and constructs a T in it.
+     * @return The new object, or nullptr if the pool is exhausted.
+     *
+     * If T's constructor throws, the slot goes back to the pool first.
+     */
+    template<typename... Args>
+    T* construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        T* slot = allocate();
+        if (!slot) return nullptr;
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return new (slot) T(std::forward<Args>(args)...);
+        } else {
+            try {
+                return new (slot) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(slot);
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief Destroys an object from construct() and returns its slot; nullptr is a no-op.
+     */
+    void destroy(T* ptr) noexcept {
+        if (!ptr) return;
+        ptr->~T();
+        deallocate(ptr);
+    }
+
+    /**
+     * @brief Allocates up to `n` objects in one go.
+     * @param out Receives the pointers to uninitialized memory.
+     * @return Number of slots written to `out`; less than `n` only if the pool ran dry.
+     *
+     * Drains this thread's magazines first, then detaches the rest of the burst
+     * **plus a fresh magazine** from the shared free list with a single CAS.
+     * A short burst counts as one exhaustion but does not run ExhaustionPolicy.
+     */
+    std::size_t allocate_bulk(T** out, std::size_t n) noexcept {
+        std::size_t done = 0;
+        auto drain = [&](Chain& chain) {
+            while (done < n && chain.count != 0) {
+                out[done++] = handOut(chain.pop());
+            }
+        };
+
+        Magazine* mag = localMagazine();
+        if (mag) {
+            drain(mag->loaded);
+            drain(mag->previous);
+            count(&ThreadCounters::cacheHits, done);
+        }
+        if (done == n) {
+            releaseMagazine(mag);
+            return n;
+        }
+
+        //Both magazines are empty here, so the surplus becomes the new `loaded`
+        Chain chain = acquireChain(n - done + (mag ? MAGAZINE_SIZE : 0));
+        drain(chain);
+        bool swept = false;
+        if constexpr (REMOTE_FREE) {
+            if (done < n && reclaimAllRemote()) {
+                swept = true;
+                chain = acquireChain(n - done + (mag ? MAGAZINE_SIZE : 0));
+                drain(chain);
+            }
+        }
+        if (mag) {
+            mag->loaded = chain;
+        }
+        releaseMagazine(mag);
+        if constexpr (PER_CPU_CACHE) {
+            //After the release: flushing claims every CPU's magazines, ours too
+            if (done < n && flushCpuCaches()) {
+                swept = true;
+                chain = acquireChain(n - done);
+                drain(chain);
+            }
+        }
+        if constexpr (GROWABLE) {
+            //Same rule as allocate(): a short count during trim() is no shortage
+            while (done < n) {
+                const std::uint64_t generation = awaitTrim();
+                chain = acquireChain(n - done);
+                drain(chain);
+                if (!trimOverlapped(generation)) break;
+            }
+        }
+        if (done < n) {
+            exhaustionCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        //What the sweeps found beyond this burst belongs to waiters first
+        if (swept) serveWaiters();
+        return done;
+    }
+
+    /**
+     * @brief Returns `n` objects to the pool; null entries are skipped.
+     * @param in Pointers previously obtained from this pool.
+     *
+     * Tops up this thread's `loaded` magazine, links everything else into one
+     * chain and splices it onto the shared free list with a single CAS.
+     * With REMOTE_FREE, slots owned by other threads go to their queues instead.
+     */
+    void deallocate_bulk(T* const* in, std::size_t n) noexcept {
+        Magazine* mag = localMagazine();
+        FreeNode* first = nullptr;
+        FreeNode* last = nullptr;
+        std::size_t freed = 0;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            T* ptr = in[i];
+            if (!ptr) continue;
+            trackFree(ptr);
+            ++freed;
+
+            auto* node = reinterpret_cast<FreeNode*>(ptr);
+            if (freeRemote(node)) continue;
+            if (mag && mag->loaded.count < MAGAZINE_SIZE) {
+                mag->loaded.push(node);
+                continue;
+            }
+            node->next = first;
+            if (!first) last = node;
+            first = node;
+        }
+        releaseMagazine(mag);
+
+        if (first) {
+            pushChain(first, last);
+        }
+        if constexpr (STATS) {
+            count(&ThreadCounters::frees, freed);
+            countInUse(-static_cast<std::int64_t>(freed));
+        }
+        (void)freed;
+        serveWaiters();
+    }
+  
+    ~LockFreeFixedSizeMemoryPool() {
+       //Waits for any in-flight thread-exit flush into this pool
+       ThreadRegistry::instance().detach(registration);
+#if LOCKFREE_POOL_HAS_COROUTINES
+       assert(!oldestWaiter && "pool destroyed while coroutines wait for a slot");
+#endif
+       //ASan keeps manual poison past munmap; clear it for whoever maps here next
+       if constexpr (DEBUG_CHECKS) {
+          unpoisonRegion(buffer, GROWABLE ? slab_count() * SLAB_BYTES : SLAB_USED_BYTES);
+       }
+       if constexpr (GROWABLE) {
+#if LOCKFREE_POOL_HAS_MMAP
+          munmap(buffer, MAX_SLABS * SLAB_BYTES);
+#endif
+       } else {
+          BackingStore::deallocate(buffer, SLAB_USED_BYTES);
+       }
+    }
+
+    LockFreeFixedSizeMemoryPool(const LockFreeFixedSizeMemoryPool&) = delete;
+    LockFreeFixedSizeMemoryPool& operator=(const LockFreeFixedSizeMemoryPool&) = delete;
+};
+
+/**
+ * @brief One LockFreeFixedSizeMemoryPool per NUMA node.
+ *
+ * Each node pool's slabs, free-list head and magazine table live on that
+ * node, so threads CAS a node-local cache line and touch node-local memory.
+ * allocate() serves the calling thread's node first and steals from the
+ * other nodes only once the local pool is empty; deallocate() sends every
+ * slot back to the pool of the node it lives on.
+ *
+ * @tparam T Type of object to allocate
+ * @tparam N Number of objects to preallocate **per node**
+ * @tparam Traits Shared by every node pool; its ExhaustionPolicy runs only
+ *         after all nodes are empty (GrowOnExhaustion grows the local node)
+ */
+template<typename T, std::size_t N, typename Traits = DefaultPoolTraits>
+class NumaLockFreeFixedSizeMemoryPool {
+public:
+    using value_type = T;
+
+private:
+    //Node pools report exhaustion immediately so the wrapper can steal
+    struct NodeTraits : Traits {
+        using ExhaustionPolicy = ReturnNullOnExhaustion;
+    };
+    using NodePool = LockFreeFixedSizeMemoryPool<T, N, NodeTraits>;
+    using ExhaustionPolicy = typename Traits::ExhaustionPolicy;
+
+    // Pool objects are placed with the node's memory policy too
+    struct NodePoolDeleter {
+        void operator()(NodePool* pool) const noexcept {
+            pool->~NodePool();
+            std::free(pool);
+        }
+    };
+
+    static constexpr std::size_t NODE_POOL_BYTES = (sizeof(NodePool) + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+
+    std::array<std::unique_ptr<NodePool, NodePoolDeleter>, Traits::MAX_NUMA_NODES> pools;
+    std::size_t nodeCount;
+
+    std::size_t localNode() const noexcept {
+        const std::size_t node = currentNumaNode();
+        return node < nodeCount ? node : 0;
+    }
+
+    T* steal(std::size_t local) noexcept {
+        for (std::size_t i = 1; i < nodeCount; ++i) {
+            if (T* slot = pools[(local + i) % nodeCount]->allocate()) {
+                return slot;
+            }
+        }
+        return nullptr;
+    }
+
+    LOCKFREE_POOL_COLD T* allocateRemote(std::size_t local) noexcept {
+        if (T* slot = steal(local)) {
+            return slot;
+        }
+        return static_cast<T*>(ExhaustionPolicy::onExhausted(
+            *this, [this, local]() noexcept -> void* {
+                if (T* slot = pools[local]->allocate()) return slot;
+                return steal(local);
+            }));
+    }
+
+public:
+    /**
+     * @throws std::bad_alloc if a node pool cannot be created
+     */
+    NumaLockFreeFixedSizeMemoryPool()
+        : nodeCount(std::min(numaNodeCount(), Traits::MAX_NUMA_NODES)) {
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            void* memory = std::aligned_alloc(PAGE_SIZE, NODE_POOL_BYTES);
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            //Before the constructor touches it, so the head and magazines land on `node`
+            bindToNumaNode(memory, NODE_POOL_BYTES, static_cast<int>(node));
+            try {
+                pools[node].reset(new (memory) NodePool(static_cast<int>(node)));
+            } catch (...) {
+                std::free(memory);
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief Allocates from the calling thread's node, stealing remotely if it is empty.
+     */
+    T* allocate() noexcept {
+        const std::size_t local = localNode();
+        if (T* slot = pools[local]->allocate()) {
+            return slot;
+        }
+        return allocateRemote(local);
+    }
+
+    /**
+     * @brief Returns `ptr` to the node pool that owns it.
+     */
+    void deallocate(T* ptr) noexcept {
+        if (!ptr) return;
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            if (pools[node]->owns(ptr)) {
+                pools[node]->deallocate(ptr);
+                return;
+            }
+        }
+        if constexpr (Traits::DEBUG_CHECKS) {
+            poolMisuse("deallocate() of a pointer no node pool allocated", ptr);
+        }
+        assert(false && "pointer was not allocated from this pool");
+    }
+
+    /**
+     * @brief Allocates a slot and constructs a T in it.
+     * @return The new object, or nullptr if the pool is exhausted.
+     *
+     * Same contract as LockFreeFixedSizeMemoryPool::construct().
+     */
+    template<typename... Args>
+    T* construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        T* slot = allocate();
+        if (!slot) return nullptr;
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return new (slot) T(std::forward<Args>(args)...);
+        } else {
+            try {
+                return new (slot) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(slot);
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief Destroys an object from construct() and returns its slot; nullptr is a no-op.
+     */
+    void destroy(T* ptr) noexcept {
+        if (!ptr) return;
+        ptr->~T();
+        deallocate(ptr);
+    }
+
+    bool owns(const T* ptr) const noexcept {
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            if (pools[node]->owns(ptr)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Grows the calling thread's node pool (see LockFreeFixedSizeMemoryPool::grow).
+     */
+    bool grow() noexcept {
+        return pools[localNode()]->grow();
+    }
+
+    /**
+     * @brief Trims every node pool (see LockFreeFixedSizeMemoryPool::trim).
+     */
+    std::size_t trim() noexcept {
+        std::size_t released = 0;
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            released += pools[node]->trim();
+        }
+        return released;
+    }
+
+    /**
+     * @brief Calls `fn(T*)` for every live slot of every node pool (Traits::TRACK_LIVE).
+     */
+    template<typename Fn>
+    void for_each_live(Fn&& fn) const {
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            pools[node]->for_each_live(fn);
+        }
+    }
+
+    std::size_t live_count() const noexcept {
+        std::size_t live = 0;
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            live += pools[node]->live_count();
+        }
+        return live;
+    }
+
+    static constexpr std::size_t max_slabs() noexcept {
+        return NodePool::max_slabs();
+    }
+
+    std::size_t node_count() const noexcept {
+        return nodeCount;
+    }
+
+    std::uint64_t exhaustion_count() const noexcept {
+        std::uint64_t total = 0;
+        for (std::size_t node = 0; node < nodeCount; ++node) {
+            total += pools[node]->exhaustion_count();
+        }
+        return total;
+    }
+
+    NumaLockFreeFixedSizeMemoryPool(const NumaLockFreeFixedSizeMemoryPool&) = delete;
+    NumaLockFreeFixedSizeMemoryPool& operator=(const NumaLockFreeFixedSizeMemoryPool&) = delete;
+};
+
+// ========== Shared-Memory Pool ========== //
+#if LOCKFREE_POOL_HAS_MMAP
+/**
+ * @brief How SharedLockFreeFixedSizeMemoryPool opens its shm_open() region.
+ */
+enum class ShmOpen {
+    Create,         // Fresh region; fails if the name exists
+    Attach,         // Existing region; fails unless its layout matches
+    CreateOrAttach  // Whichever applies (default)
+};
+
+/**
+ * @brief Fixed-size pool living in a POSIX shared-memory region.
+ *
+ * Every process that maps the same name allocates from, frees into and
+ * reads the same slots: zero-copy handoff of T between processes. Nothing
+ * in the region is an address, since each process maps it elsewhere; the
+ * free list is a 64-bit word holding a 32-bit slot index and a 32-bit ABA
+ * tag, free slots link by index, and a Handle is a slot index that
+ * get() turns into a local pointer with one multiply-add.
+ *
+ * No magazines: per-thread caches are process-local and would strand slots
+ * when a process exits. Allocation is one tagged single-width CAS.
+ *
+ * @tparam T Trivially copyable; its bytes must mean the same in every process
+ * @tparam Traits SlotLayout and ExhaustionPolicy apply; everything else is ignored
+ */
+template<typename T, std::size_t N, typename Traits = DefaultPoolTraits>
+class SharedLockFreeFixedSizeMemoryPool {
+public:
+    using value_type = T;
+    using Handle = std::uint32_t;
+    static constexpr Handle NULL_HANDLE = 0xFFFFFFFF;
+
+private:
+    using ExhaustionPolicy = typename Traits::ExhaustionPolicy;
+    using Ordering = typename Traits::Ordering;
+
+    static constexpr std::size_t SLOT_MIN_SIZE = std::max(sizeof(T), sizeof(std::uint32_t));
+    static constexpr std::size_t SLOT_ALIGN = std::max(alignof(T), alignof(std::uint32_t));
+    static constexpr std::size_t SLOT_SIZE =
+        Traits::SlotLayout::template stride<SLOT_MIN_SIZE, SLOT_ALIGN>();
+
+    static_assert(std::is_trivially_copyable_v<T>, "Objects shared between processes must be trivially copyable");
+    static_assert(N > 0 && N < NULL_HANDLE, "Slot indices are 32-bit");
+    static_assert(SLOT_SIZE >= sizeof(T) && SLOT_SIZE % SLOT_ALIGN == 0, "Slot stride cannot hold T");
+    static_assert(SLOT_ALIGN <= PAGE_SIZE, "Over-aligned T: alignof(T) exceeds a page");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "The shared head needs an address-free 64-bit CAS");
+
+    static constexpr std::uint64_t MAGIC = 0x4C46504F4F4C3031;  // "LFPOOL01"
+    enum : std::uint32_t { UNINITIALIZED = 0, READY = 1 };
+
+    // Start of the region; identical in every process that maps it
+    struct Header {
+        std::uint64_t magic;
+        std::uint64_t slotSize;
+        std::uint64_t slotCount;
+        std::atomic<std::uint32_t> state;
+        //Low 32 bits: index of the first free slot; high 32 bits: ABA tag
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;
+    };
+
+    static constexpr std::size_t SLOTS_OFFSET = roundUpTo(sizeof(Header), std::max(CACHE_LINE_SIZE, SLOT_ALIGN));
+    static constexpr std::size_t REGION_BYTES = roundUpTo(SLOTS_OFFSET + N * SLOT_SIZE, PAGE_SIZE);
+
+    Header* header = nullptr;
+    std::byte* slots = nullptr;
+
+    static constexpr std::uint32_t indexOf(std::uint64_t word) noexcept {
+        return static_cast<std::uint32_t>(word);
+    }
+
+    static constexpr std::uint64_t pack(std::uint32_t index, std::uint64_t previous) noexcept {
+        return ((previous >> 32) + 1) << 32 | index;
+    }
+
+    // Free slots hold the index of the next free slot in their first bytes
+    std::uint32_t& nextOf(std::uint32_t index) const noexcept {
+        return *reinterpret_cast<std::uint32_t*>(slots + std::size_t{index} * SLOT_SIZE);
+    }
+
+    // nextOf() a slot another process may have popped and be writing to; the
+    // tagged CAS throws the value away then, so the race is benign. Reads the
+    // slot itself: a sanitized nextOf() would not be inlined here.
+    LOCKFREE_POOL_NO_TSAN std::uint32_t speculativeNextOf(std::uint32_t index) const noexcept {
+        return *reinterpret_cast<const std::uint32_t*>(slots + std::size_t{index} * SLOT_SIZE);
+    }
+
+    [[noreturn]] static void fail(int error, const char* what) {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void initialize() noexcept {
+        for (std::uint32_t i = 0; i < N; ++i) {
+            nextOf(i) = i + 1 < N ? i + 1 : NULL_HANDLE;
+        }
+        header->magic = MAGIC;
+        header->slotSize = SLOT_SIZE;
+        header->slotCount = N;
+        header->head.store(0, std::memory_order_relaxed);
+        header->state.store(READY, std::memory_order_release);
+    }
+
+    //The creator may still be sizing or linking the region: wait a bounded time
+    void awaitReady(int fd) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        struct stat info {};
+        for (;;) {
+            if (fstat(fd, &info) != 0) fail(errno, "fstat of shared pool region");
+            if (info.st_size != 0) break;
+            if (std::chrono::steady_clock::now() > deadline) fail(ETIMEDOUT, "shared pool region never sized");
+            std::this_thread::yield();
+        }
+        //The creator sizes the region in one step: any other size is another layout
+        if (static_cast<std::size_t>(info.st_size) != REGION_BYTES) {
+            fail(EINVAL, "shared pool region has a different layout");
+        }
+        map(fd);
+        while (header->state.load(std::memory_order_acquire) != READY) {
+            if (std::chrono::steady_clock::now() > deadline) fail(ETIMEDOUT, "shared pool never initialized");
+            std::this_thread::yield();
+        }
+        if (header->magic != MAGIC || header->slotSize != SLOT_SIZE || header->slotCount != N) {
+            fail(EINVAL, "shared pool region has a different layout");
+        }
+    }
+
+    void map(int fd) {
+        void* p = mmap(nullptr, REGION_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) fail(errno, "mmap of shared pool region");
+        header = static_cast<Header*>(p);
+        slots = static_cast<std::byte*>(p) + SLOTS_OFFSET;
+    }
+
+public:
+    /**
+     * @param name shm_open() name, e.g. "/orders"
+     * @throws std::system_error if the region cannot be opened, sized or
+     *         mapped, or an attached region was built for another T or N
+     */
+    explicit SharedLockFreeFixedSizeMemoryPool(const char* name, ShmOpen mode = ShmOpen::CreateOrAttach) {
+        bool created = false;
+        int fd = -1;
+        if (mode != ShmOpen::Attach) {
+            fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+            created = fd >= 0;
+            if (!created && (errno != EEXIST || mode == ShmOpen::Create)) fail(errno, "shm_open");
+        }
+        if (!created) {
+            fd = shm_open(name, O_RDWR, 0600);
+            if (fd < 0) fail(errno, "shm_open");
+        }
+
+        try {
+            if (created) {
+                //Fresh pages read as zero, so attachers see UNINITIALIZED until we are done
+                if (ftruncate(fd, static_cast<off_t>(REGION_BYTES)) != 0) fail(errno, "ftruncate");
+                map(fd);
+                initialize();
+            } else {
+                awaitReady(fd);
+            }
+        } catch (...) {
+            if (header) munmap(header, REGION_BYTES);
+            close(fd);
+            if (created) shm_unlink(name);
+            throw;
+        }
+        close(fd);
+    }
+
+    /**
+     * @brief Removes the name; processes that still map the region keep it.
+     */
+    static bool unlink(const char* name) noexcept {
+        return shm_unlink(name) == 0;
+    }
+
+    /**
+     * @return Uninitialized slot, or whatever ExhaustionPolicy yields when empty.
+     */
+    T* allocate() noexcept {
+        if (T* slot = popSlot()) return slot;
+        return static_cast<T*>(ExhaustionPolicy::onExhausted(*this, [this]() noexcept -> void* {
+            return popSlot();
+        }));
+    }
+
+    /**
+     * @brief Returns a slot; any process may free a slot any other allocated.
+     */
+    void deallocate(T* ptr) noexcept {
+        if (!ptr) return;
+        assert(owns(ptr) && "pointer was not allocated from this shared pool");
+        const Handle index = handle_of(ptr);
+        std::uint64_t head = header->head.load(Ordering::PUSH_FAILURE);
+        do {
+            nextOf(index) = indexOf(head);
+        } while (!header->head.compare_exchange_weak(head, pack(index, head), Ordering::PUSH,
+                                                     Ordering::PUSH_FAILURE));
+    }
+
+    /**
+     * @brief Process-independent name of a slot, to pass to another process.
+     */
+    Handle handle_of(const T* ptr) const noexcept {
+        if (!ptr) return NULL_HANDLE;
+        return static_cast<Handle>((reinterpret_cast<const std::byte*>(ptr) - slots) / SLOT_SIZE);
+    }
+
+    /**
+     * @brief This process's address of the slot named by `handle`.
+     */
+    T* get(Handle handle) const noexcept {
+        if (handle == NULL_HANDLE) return nullptr;
+        assert(handle < N && "handle out of range");
+        return reinterpret_cast<T*>(slots + std::size_t{handle} * SLOT_SIZE);
+    }
+
+    Handle allocate_handle() noexcept {
+        return handle_of(allocate());
+    }
+
+    void deallocate_handle(Handle handle) noexcept {
+        deallocate(get(handle));
+    }
+
+    bool owns(const T* ptr) const noexcept {
+        const auto offset = static_cast<std::uintptr_t>(reinterpret_cast<const std::byte*>(ptr) - slots);
+        return (offset < N * SLOT_SIZE) & (offset % SLOT_SIZE == 0);
+    }
+
+    static constexpr std::size_t max_slabs() noexcept {
+        return 1;
+    }
+
+    static constexpr std::size_t capacity() noexcept {
+        return N;
+    }
+
+    static constexpr std::size_t slot_size() noexcept {
+        return SLOT_SIZE;
+    }
+
+    ~SharedLockFreeFixedSizeMemoryPool() {
+        if (header) munmap(header, REGION_BYTES);
+    }
+
+    SharedLockFreeFixedSizeMemoryPool(const SharedLockFreeFixedSizeMemoryPool&) = delete;
+    SharedLockFreeFixedSizeMemoryPool& operator=(const SharedLockFreeFixedSizeMemoryPool&) = delete;
+
+private:
+    T* popSlot() noexcept {
+        std::uint64_t head = header->head.load(Ordering::HEAD_LOAD);
+        while (indexOf(head) != NULL_HANDLE) {
+            const std::uint32_t next = speculativeNextOf(indexOf(head));
+            if (header->head.compare_exchange_weak(head, pack(next, head), Ordering::POP, Ordering::POP_FAILURE)) {
+                return get(indexOf(head));
+            }
+        }
+        return nullptr;
+    }
+};
+#endif // LOCKFREE_POOL_HAS_MMAP
+
+// ========== Warm-Object Pool ========== //
+/**
+ * @brief N objects constructed once, then recycled without being destroyed.
+ *
+ * For types whose constructor is the expensive part (preallocated inner
+ * buffers, registered callbacks): acquire() returns a live object and
+ * release() runs Traits::Reset on it and puts it back, so the hot path
+ * never runs a constructor or destructor. Objects stay alive while free,
+ * so the free list cannot live inside them: it is a side array of 32-bit
+ * slot indices under a 64-bit head (index + ABA tag), and popping never
+ * touches object memory. Recycling is LIFO: the object released last,
+ * still warm, is acquired first.
+ *
+ * Each thread caches up to 2 * MAGAZINE_SIZE free indices in a flat array,
+ * refilled one magazine at a time with a single CAS and spilled the same
+ * way; the cache is flushed back when the thread exits.
+ *
+ * @tparam T Built N times from the pool constructor's arguments
+ * @tparam Traits MAGAZINE_SIZE, MAX_THREADS, SlotLayout, BackingStore,
+ *         ExhaustionPolicy, Reset and PREFETCH_NEXT apply; the rest is ignored
+ */
+template<typename T, std::size_t N, typename Traits = DefaultPoolTraits>
+class WarmObjectPool {
+public:
+    using value_type = T;
+    using Handle = std::uint32_t;
+    static constexpr Handle NULL_HANDLE = 0xFFFFFFFF;
+
+private:
+    using ExhaustionPolicy = typename Traits::ExhaustionPolicy;
+    using BackingStore = typename Traits::BackingStore;
+    using Reset = typename Traits::Reset;
+    using Ordering = typename Traits::Ordering;
+    static constexpr std::size_t MAGAZINE_SIZE = Traits::MAGAZINE_SIZE;
+    static constexpr std::size_t MAX_THREADS = Traits::MAX_THREADS;
+
+    //No link inside the slot, so it only has to fit T
+    static constexpr std::size_t SLOT_SIZE = Traits::SlotLayout::template stride<sizeof(T), alignof(T)>();
+    static constexpr std::size_t BUFFER_ALIGN = std::max(CACHE_LINE_SIZE, alignof(T));
+    static constexpr std::size_t BUFFER_BYTES = N * SLOT_SIZE;
+
+    static_assert(N > 0 && N < NULL_HANDLE, "Slot indices are 32-bit");
+    static_assert(SLOT_SIZE >= sizeof(T) && SLOT_SIZE % alignof(T) == 0, "Slot stride cannot hold T");
+    static_assert(BUFFER_ALIGN <= PAGE_SIZE, "Over-aligned T: alignof(T) exceeds a page");
+    static_assert(std::is_nothrow_invocable_v<Reset, T&>, "Traits::Reset must be noexcept: release() cannot fail");
+
+    std::byte* slots = nullptr;
+    //nextFree[i]: index of the free slot after slot i (NULL_HANDLE ends the list)
+    std::unique_ptr<std::atomic<std::uint32_t>[]> nextFree;
+    //Low 32 bits: index of the first free slot; high 32 bits: ABA tag
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> exhaustionCount{0};
+
+    static constexpr std::uint32_t indexOf(std::uint64_t word) noexcept {
+        return static_cast<std::uint32_t>(word);
+    }
+
+    static constexpr std::uint64_t pack(std::uint32_t index, std::uint64_t previous) noexcept {
+        return ((previous >> 32) + 1) << 32 | index;
+    }
+
+    // Stack of free indices, top at indices[count - 1]; owned by one thread
+    struct alignas(CACHE_LINE_SIZE) Magazine {
+        std::size_t count = 0;
+        std::array<std::uint32_t, 2 * MAGAZINE_SIZE> indices;
+    };
+
+    std::array<Magazine, MAX_THREADS> magazines{};
+    ThreadRegistry::Hook registration;
+
+    Magazine* localMagazine() noexcept {
+        const std::size_t index = currentThreadIndex();
+        return index < MAX_THREADS ? &magazines[index] : nullptr;
+    }
+
+    // Links indices[0, count) through nextFree and splices them on with one CAS
+    void pushIndices(const std::uint32_t* indices, std::size_t count) noexcept {
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            nextFree[indices[i]].store(indices[i + 1], std::memory_order_relaxed);
+        }
+        const std::uint32_t last = indices[count - 1];
+        std::uint64_t current = head.load(Ordering::PUSH_FAILURE);
+        do {
+            nextFree[last].store(indexOf(current), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(current, pack(indices[0], current), Ordering::PUSH,
+                                             Ordering::PUSH_FAILURE));
+    }
+
+    /**
+     * @brief Takes up to `max` indices off the shared list with one successful CAS.
+     * @return Number written to `out`, head of the list last (top of a magazine).
+     *
+     * Walking reads links another thread may be rewriting; they always name
+     * some slot, so a stale walk stays in bounds and the tag fails its CAS.
+     */
+    std::size_t popIndices(std::uint32_t* out, std::size_t max) noexcept {
+        std::uint64_t current = head.load(Ordering::HEAD_LOAD);
+        while (indexOf(current) != NULL_HANDLE) {
+            std::uint32_t index = indexOf(current);
+            std::size_t count = 0;
+            while (index != NULL_HANDLE && count < max) {
+                out[max - 1 - count++] = index;
+                index = nextFree[index].load(std::memory_order_relaxed);
+            }
+            if (head.compare_exchange_weak(current, pack(index, current), Ordering::POP, Ordering::POP_FAILURE)) {
+                std::copy(out + max - count, out + max, out);
+                return count;
+            }
+        }
+        return 0;
+    }
+
+    T* popObject() noexcept {
+        Magazine* mag = localMagazine();
+        if (!mag) {
+            std::uint32_t index;
+            return popIndices(&index, 1) ? get(index) : nullptr;
+        }
+        if (mag->count == 0) {
+            mag->count = popIndices(mag->indices.data(), MAGAZINE_SIZE);
+            if (mag->count == 0) return nullptr;
+        }
+        T* obj = get(mag->indices[--mag->count]);
+        if constexpr (Traits::PREFETCH_NEXT) {
+            //The side array keeps objects cold until used: warm the next one now
+            if (mag->count != 0) prefetchForWrite(get(mag->indices[mag->count - 1]));
+        }
+        return obj;
+    }
+
+    void flushThread(std::size_t index) noexcept {
+        if (index >= MAX_THREADS) return;
+        Magazine& mag = magazines[index];
+        if (mag.count != 0) {
+            pushIndices(mag.indices.data(), mag.count);
+            mag.count = 0;
+        }
+    }
+
+    static ThreadRegistry::Deferred* flushExitingThread(void* pool, std::size_t index) noexcept {
+        static_cast<WarmObjectPool*>(pool)->flushThread(index);
+        return nullptr;
+    }
+
+public:
+    /**
+     * @brief Constructs all N objects as T(args...).
+     * @throws std::bad_alloc if the slots cannot be allocated, or whatever T's constructor throws
+     */
+    template<typename... Args>
+    explicit WarmObjectPool(const Args&... args) {
+        slots = static_cast<std::byte*>(BackingStore::allocate(BUFFER_BYTES, BUFFER_ALIGN));
+        if (!slots) {
+            throw std::bad_alloc();
+        }
+        BackingStore::prepare(slots, BUFFER_BYTES);
+
+        std::size_t built = 0;
+        try {
+            nextFree.reset(new std::atomic<std::uint32_t>[N]);
+            for (; built < N; ++built) {
+                new (slots + built * SLOT_SIZE) T(args...);
+            }
+        } catch (...) {
+            while (built > 0) get(static_cast<Handle>(--built))->~T();
+            BackingStore::deallocate(slots, BUFFER_BYTES);
+            throw;
+        }
+
+        for (std::uint32_t i = 0; i < N; ++i) {
+            nextFree[i].store(i + 1 < N ? i + 1 : NULL_HANDLE, std::memory_order_relaxed);
+        }
+        head.store(0, std::memory_order_release);
+
+        registration.flush = &flushExitingThread;
+        registration.pool = this;
+        ThreadRegistry::instance().attach(registration);
+    }
+
+    /**
+     * @return A constructed object, or whatever ExhaustionPolicy yields
+     *         (nullptr by default) while all N are out.
+     */
+    T* acquire() noexcept {
+        if (T* obj = popObject()) return obj;
+        exhaustionCount.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<T*>(ExhaustionPolicy::onExhausted(*this, [this]() noexcept -> void* {
+            return popObject();
+        }));
+    }
+
+    /**
+     * @brief Resets `obj` with Traits::Reset and makes it available again; nullptr is a no-op.
+     */
+    void release(T* obj) noexcept {
+        if (!obj) return;
+        assert(owns(obj) && "object was not acquired from this pool");
+        Reset{}(*obj);
+        const Handle index = handle_of(obj);
+        Magazine* mag = localMagazine();
+        if (!mag) {
+            pushIndices(&index, 1);
+            return;
+        }
+        if (mag->count == 2 * MAGAZINE_SIZE) {
+            //Spill the older, colder half with one CAS and keep the warm top
+            pushIndices(mag->indices.data(), MAGAZINE_SIZE);
+            std::copy(mag->indices.begin() + MAGAZINE_SIZE, mag->indices.end(), mag->indices.begin());
+            mag->count = MAGAZINE_SIZE;
+        }
+        mag->indices[mag->count++] = index;
+    }
+
+    /**
+     * @brief Returns the calling thread's cached objects to the shared list.
+     */
+    void flush_thread_cache() noexcept {
+        flushThread(currentThreadIndex());
+    }
+
+    Handle handle_of(const T* obj) const noexcept {
+        if (!obj) return NULL_HANDLE;
+        return static_cast<Handle>((reinterpret_cast<const std::byte*>(obj) - slots) / SLOT_SIZE);
+    }
+
+    T* get(Handle handle) const noexcept {
+        if (handle == NULL_HANDLE) return nullptr;
+        assert(handle < N && "handle out of range");
+        return std::launder(reinterpret_cast<T*>(slots + std::size_t{handle} * SLOT_SIZE));
+    }
+
+    bool owns(const T* obj) const noexcept {
+        const auto offset = static_cast<std::uintptr_t>(reinterpret_cast<const std::byte*>(obj) - slots);
+        return (offset < BUFFER_BYTES) & (offset % SLOT_SIZE == 0);
+    }
+
+    std::uint64_t exhaustion_count() const noexcept {
+        return exhaustionCount.load(std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t max_slabs() noexcept {
+        return 1;
+    }
+
+    static constexpr std::size_t capacity() noexcept {
+        return N;
+    }
+
+    static constexpr std::size_t slot_size() noexcept {
+        return SLOT_SIZE;
+    }
+
+    /**
+     * @brief Destroys all N objects, including any never released.
+     */
+    ~WarmObjectPool() {
+        ThreadRegistry::instance().detach(registration);
+        for (std::uint32_t i = 0; i < N; ++i) get(i)->~T();
+        BackingStore::deallocate(slots, BUFFER_BYTES);
+    }
+
+    WarmObjectPool(const WarmObjectPool&) = delete;
+    WarmObjectPool& operator=(const WarmObjectPool&) = delete;
+};
+
+// ========== Pool-Backed Smart Pointer ========== //
+/**
+ * @brief Stateless deleter that hands objects back to a pool with static storage.
+ *
+ * The pool is a template argument, not a member, so `PoolPtr` stays the size
+ * of a raw pointer and moves through queues with no extra word or heap state.
+ * @tparam Pool Any pool object with static storage duration
+ */
+template<auto& Pool>
+struct PoolDeleter {
+    template<typename U>
+    void operator()(U* ptr) const noexcept {
+        Pool.destroy(ptr);
+    }
+};
+
+/**
+ * @brief Move-only owner of an object living in `Pool`.
+ */
+template<auto& Pool>
+using PoolPtr = std::unique_ptr<typename std::remove_reference_t<decltype(Pool)>::value_type, PoolDeleter<Pool>>;
+
+/**
+ * @brief Constructs a T in `Pool` and wraps it; empty PoolPtr if the pool is exhausted.
+ */
+template<auto& Pool, typename... Args>
+PoolPtr<Pool> make_pooled(Args&&... args) {
+    return PoolPtr<Pool>(Pool.construct(std::forward<Args>(args)...));
+}
+
+// ========== STL Allocator Adapter ========== //
+/**
+ * @brief Stateless std::allocator-compatible adapter for node-based containers.
+ *
+ * Every rebound type U gets its own process-wide LockFreeFixedSizeMemoryPool<U, N, Traits>,
+ * so std::list / std::map / std::unordered_map nodes come from a pool sized for
+ * exactly that node. Requests for more than one object (vectors, hash bucket
+ * arrays) go to ::operator new, and so do single nodes while the pool is
+ * exhausted, as with PoolMemoryResource; owns() tells them apart on deallocate.
+ *
+ * @code
+ * std::map<std::uint64_t, Order, std::less<>,
+ *          PoolAllocator<std::pair<const std::uint64_t, Order>, 1 << 16>> book;
+ * @endcode
+ *
+ * @tparam T Value type the container asks for
+ * @tparam N Slots in each per-type pool
+ * @tparam Traits Pool configuration; its ExhaustionPolicy runs before the heap fallback
+ */
+template<typename T, std::size_t N = 4096, typename Traits = DefaultPoolTraits>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using Pool = LockFreeFixedSizeMemoryPool<T, N, Traits>;
+
+    template<typename U>
+    struct rebind {
+        using other = PoolAllocator<U, N, Traits>;
+    };
+
+    PoolAllocator() noexcept = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U, N, Traits>&) noexcept {}
+
+    /**
+     * @brief Shared pool for T; never destroyed, so containers with static
+     *        storage can still free into it during program exit.
+     */
+    static Pool& pool() {
+        static Pool* const instance = new Pool();
+        return *instance;
+    }
+
+    /**
+     * @brief Largest `n` whose `n * sizeof(T)` bytes do not overflow std::size_t.
+     */
+    static constexpr std::size_t max_size() noexcept {
+        return std::numeric_limits<std::size_t>::max() / sizeof(T);
+    }
+
+    /**
+     * @throws std::bad_array_new_length if `n` exceeds max_size(), as std::allocator does
+     * @throws std::bad_alloc if ::operator new is out of memory
+     */
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            if (T* slot = pool().allocate()) return slot;
+        } else if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if (n == 1 && pool().owns(ptr)) {
+            pool().deallocate(ptr);
+            return;
+        }
+        ::operator delete(ptr, std::align_val_t{alignof(T)});
+    }
 
+    template<typename U>
+    bool operator==(const PoolAllocator<U, N, Traits>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U, N, Traits>&) const noexcept { return false; }
+};
+
+// ========== Polymorphic Memory Resource ========== //
 /**
- * @brief Ultra-low-latency lock-free memory pool for fixed-size objects.
- * 
- * This memory pool is **preallocated, lock-free, and cache-line optimized**.
- * Designed for **HFT or real-time systems**, where allocation speed and
- * cache behavior are critical.
- * 
- * @tparam T Type of object to allocate
- * @tparam N Number of objects to preallocate
+ * @brief std::pmr::memory_resource that serves slot-sized requests from a pool.
+ *
+ * Requests that fit one slot (size and alignment) are popped from `pool`;
+ * larger ones, and slot-sized ones while the pool is exhausted, go to
+ * `upstream`. Deallocation is routed with the pool's O(1) owns().
+ *
+ * @tparam Pool Any pool exposing allocate/deallocate/owns/slot_size/slot_alignment
  */
-template<typename T, std::size_t N>
-class LockFreeFixedSizeMemoryPool {
+template<typename Pool>
+class PoolMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit PoolMemoryResource(Pool& pool,
+                                std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : pool_(pool), upstream_(upstream) {}
+
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
 private:
-    struct FreeNode {
-        FreeNode* next;
-    };
+    using Slot = typename Pool::value_type;
 
-    //alignas(CACHE_LINE_SIZE) std::byte buffer[N * sizeof(T)];
-    std::byte* buffer; //To create in heap always 
-    //If freeList is accessed heavily, align it to CACHE_LINE_SIZE to avoid contention:
-    alignas(CACHE_LINE_SIZE) std::atomic<FreeNode*> freeList;
+    Pool& pool_;
+    std::pmr::memory_resource* upstream_;
 
-    // ========== Thread-Local Caching ========== //
-    static thread_local FreeNode* localCacheHead; 
+    static bool fits(std::size_t bytes, std::size_t alignment) noexcept {
+        return bytes <= Pool::slot_size() && alignment <= Pool::slot_alignment();
+    }
 
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (fits(bytes, alignment)) {
+            if (void* slot = pool_.allocate()) return slot;
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
 
-public:
-      LockFreeFixedSizeMemoryPool() noexcept {
-         //aligned_alloc() to ensure cacheline alignment
-         buffer = static_cast<std::byte*>(std::aligned_alloc(CACHE_LINE_SIZE, N * sizeof(T)));
-         if (!buffer) {
-            throw std::bad_alloc();
-         }
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        if (fits(bytes, alignment) && pool_.owns(static_cast<const Slot*>(ptr))) {
+            pool_.deallocate(static_cast<Slot*>(ptr));
+            return;
+        }
+        upstream_->deallocate(ptr, bytes, alignment);
+    }
 
-         FreeNode* head = nullptr;
-        //Optimize Free List Initialization**
-        //Reverse-order linking is fine, but forward linking might improve cache locality:
-        //for (std::size_t i = 0; i < N; ++i) {
-            //auto* node = reinterpret_cast<FreeNode*>(&buffer[i * sizeof(T)]);
-        for (std::size_t i = N; i > 0; --i) {
-            auto* node = reinterpret_cast<FreeNode*>(&buffer[(i-1)*sizeof(T)]);
-            node->next = head;
-            head = node;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// ========== Size-Class Allocator ========== //
+/**
+ * @brief Compile-time list of slot sizes, smallest first.
+ */
+template<std::size_t... SIZES>
+struct SizeClasses {};
+
+/**
+ * @brief Raw storage for one size class; aligned to the largest power of two
+ *        dividing SIZE, capped at alignof(std::max_align_t).
+ */
+template<std::size_t SIZE>
+struct alignas((SIZE & (~SIZE + 1)) < alignof(std::max_align_t) ? (SIZE & (~SIZE + 1))
+                                                                  : alignof(std::max_align_t))
+SizeClassSlot {
+    std::byte bytes[SIZE];
+};
+
+template<typename Classes = SizeClasses<16, 32, 64, 128, 256, 512>,
+         std::size_t N = 4096, typename Traits = DefaultPoolTraits>
+class SizeClassAllocator;
+
+/**
+ * @brief One allocator for many small object types, built from one
+ *        LockFreeFixedSizeMemoryPool per size class.
+ *
+ * A request is mapped to its class through a constexpr table indexed by
+ * size / granule (no compare chain) and dispatched by index; typed calls
+ * pick the class at compile time. Every class is a full pool, so each one
+ * keeps its own per-thread magazines and lock-free global list.
+ *
+ * @tparam Classes SizeClasses<...> in ascending order
+ * @tparam N Slots per size class
+ * @tparam Traits Configuration shared by every class pool
+ */
+template<std::size_t... SIZES, std::size_t N, typename Traits>
+class SizeClassAllocator<SizeClasses<SIZES...>, N, Traits> {
+private:
+    static constexpr std::size_t CLASS_COUNT = sizeof...(SIZES);
+    static constexpr std::array<std::size_t, CLASS_COUNT> CLASS_SIZES{SIZES...};
+    static constexpr std::size_t MAX_SIZE = CLASS_SIZES[CLASS_COUNT - 1];
+    //Every class size is a multiple of the granule, so the table has no gaps
+    static constexpr std::size_t GRANULE = [] {
+        std::size_t granule = 0;
+        for (std::size_t size : CLASS_SIZES) granule = std::gcd(granule, size);
+        return granule;
+    }();
+
+    static_assert(CLASS_COUNT > 0, "At least one size class is required");
+    static_assert(CLASS_COUNT <= 256, "Class indices are stored as bytes");
+    static_assert([] {
+        for (std::size_t i = 1; i < CLASS_COUNT; ++i) {
+            if (CLASS_SIZES[i - 1] >= CLASS_SIZES[i]) return false;
+        }
+        return true;
+    }(), "Size classes must be strictly ascending");
+
+    // CLASS_TABLE[ceil(bytes / GRANULE)] = smallest class that fits `bytes`
+    static constexpr auto CLASS_TABLE = [] {
+        std::array<std::uint8_t, MAX_SIZE / GRANULE + 1> table{};
+        std::size_t cls = 0;
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            while (CLASS_SIZES[cls] < i * GRANULE) ++cls;
+            table[i] = static_cast<std::uint8_t>(cls);
         }
-        freeList.store(head, std::memory_order_release);
+        return table;
+    }();
+
+    template<std::size_t I>
+    using ClassPool = LockFreeFixedSizeMemoryPool<SizeClassSlot<CLASS_SIZES[I]>, N, Traits>;
+
+    std::tuple<LockFreeFixedSizeMemoryPool<SizeClassSlot<SIZES>, N, Traits>...> pools;
+
+    using AllocateFn = void* (*)(SizeClassAllocator&) noexcept;
+    using DeallocateFn = void (*)(SizeClassAllocator&, void*) noexcept;
+
+    template<std::size_t I>
+    static void* allocateFrom(SizeClassAllocator& self) noexcept {
+        return std::get<I>(self.pools).allocate();
+    }
+
+    template<std::size_t I>
+    static void deallocateTo(SizeClassAllocator& self, void* ptr) noexcept {
+        auto& pool = std::get<I>(self.pools);
+        pool.deallocate(static_cast<typename ClassPool<I>::value_type*>(ptr));
+    }
+
+    template<std::size_t... Is>
+    static constexpr std::array<AllocateFn, CLASS_COUNT> allocateTable(std::index_sequence<Is...>) noexcept {
+        return {{&allocateFrom<Is>...}};
+    }
+
+    template<std::size_t... Is>
+    static constexpr std::array<DeallocateFn, CLASS_COUNT> deallocateTable(std::index_sequence<Is...>) noexcept {
+        return {{&deallocateTo<Is>...}};
+    }
+
+    template<std::size_t... Is>
+    bool ownsAny(const void* ptr, std::index_sequence<Is...>) const noexcept {
+        return (std::get<Is>(pools).owns(static_cast<const typename ClassPool<Is>::value_type*>(ptr)) | ...);
     }
 
+public:
     /**
-     * @brief Allocates memory for one object.
-     * @return Pointer to uninitialized memory.
-     * 
-     * Uses **thread-local cache** for faster allocations.
-     * If exhausted, falls back to **dynamic memory allocation**.
+     * @brief Index of the smallest class holding `bytes` (bytes <= max_size()).
      */
-    T* allocate() noexcept {
-        if (localCacheHead) {
-           FreeNode* cached = localCacheHead;
-           localCacheHead = cached->next;
-           return reinterpret_cast<T*>(cached);
-        }
+    static constexpr std::size_t class_index(std::size_t bytes) noexcept {
+        return CLASS_TABLE[(bytes + GRANULE - 1) / GRANULE];
+    }
 
-        FreeNode* head = freeList.load(std::memory_order_acquire);
-        while (head) {
-            FreeNode* next = head->next;
-            if (freeList.compare_exchange_weak(head, next, std::memory_order_acq_rel)) {
-                return reinterpret_cast<T*>(head);
-            }
-        }
+    static constexpr std::size_t class_size(std::size_t index) noexcept {
+        return CLASS_SIZES[index];
+    }
 
-        // ========= Fallback: Dynamic Allocation ========= //
-        //TODO: Dynamic memory allication at hot path is not exoected for low latency. 
-        //Its just for demo purpose 
-        std::cerr << "Memory pool exhausted! Falling back to dynamic allocation.\n";
-        return reinterpret_cast<T*>(new std::byte[sizeof(T)]);
+    static constexpr std::size_t max_size() noexcept {
+        return MAX_SIZE;
     }
 
     /**
-     * @brief Deallocates memory, returning it back to the pool.
-     * @param ptr Pointer to memory previously allocated by `allocate()`.
-     * 
-     * **Handles dynamically allocated fallback memory separately**.
+     * @brief Slot of the smallest class that fits `bytes`.
+     * @return nullptr if `bytes` exceeds max_size() or that class is exhausted.
      */
-    void deallocate(T* ptr) noexcept {
-        if (!ptr) return;
+    void* allocate(std::size_t bytes) noexcept {
+        static constexpr auto table = allocateTable(std::make_index_sequence<CLASS_COUNT>{});
+        if (bytes > MAX_SIZE) return nullptr;
+        return table[class_index(bytes)](*this);
+    }
 
-        // Check if memory came from the fallback dynamic allocation
-        //TODO: Needs to handle thread safety worhout lock
-        if (reinterpret_cast<std::byte*>(ptr) < buffer.data() ||
-            reinterpret_cast<std::byte*>(ptr) >= buffer.data() + buffer.size()) {
-            delete[] reinterpret_cast<std::byte*>(ptr);  // Clean up fallback allocation
-            return;
-        }
+    /**
+     * @brief Returns memory from allocate(bytes); `bytes` must match the request.
+     */
+    void deallocate(void* ptr, std::size_t bytes) noexcept {
+        static constexpr auto table = deallocateTable(std::make_index_sequence<CLASS_COUNT>{});
+        if (!ptr) return;
+        assert(bytes <= MAX_SIZE && "size was never served by this allocator");
+        table[class_index(bytes)](*this, ptr);
+    }
 
-        // Return object to thread-local cache for faster reuse
-        auto* node = reinterpret_cast<FreeNode*>(ptr);
-         node->next = localCacheHead;
-         localCacheHead = node;
+    bool owns(const void* ptr) const noexcept {
+        return ownsAny(ptr, std::make_index_sequence<CLASS_COUNT>{});
     }
-  
-    ~LockFreeFixedSizeMemoryPool() {
-       std::free(buffer);  
+
+    /**
+     * @brief Constructs a T in its size class, picked at compile time.
+     */
+    template<typename T, typename... Args>
+    T* construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        static_assert(sizeof(T) <= MAX_SIZE, "T is larger than the largest size class");
+        constexpr std::size_t I = class_index(sizeof(T));
+        static_assert(alignof(T) <= alignof(SizeClassSlot<CLASS_SIZES[I]>),
+                      "T is over-aligned for its size class");
+        auto* slot = std::get<I>(pools).allocate();
+        if (!slot) return nullptr;
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return new (slot) T(std::forward<Args>(args)...);
+        } else {
+            try {
+                return new (slot) T(std::forward<Args>(args)...);
+            } catch (...) {
+                std::get<I>(pools).deallocate(slot);
+                throw;
+            }
+        }
     }
 
-    LockFreeFixedSizeMemoryPool(const LockFreeFixedSizeMemoryPool&) = delete;
-    LockFreeFixedSizeMemoryPool& operator=(const LockFreeFixedSizeMemoryPool&) = delete;
+    template<typename T>
+    void destroy(T* ptr) noexcept {
+        if (!ptr) return;
+        constexpr std::size_t I = class_index(sizeof(T));
+        ptr->~T();
+        std::get<I>(pools).deallocate(reinterpret_cast<typename ClassPool<I>::value_type*>(ptr));
+    }
 };
 
-template<typename T, std::size_t N>
-thread_local typename LockFreeFixedSizeMemoryPool<T, N>::FreeNode* LockFreeFixedSizeMemoryPool<T, N>::localCacheHead = nullptr;
-
 /************* Usage Example **************/
+#ifndef LOCKFREE_POOL_NO_EXAMPLE_MAIN
+#include <list>         // std::pmr::list
+#include <map>          // std::map
 
-struct alignas(CACHE_LINE_SIZE) Order {
+//No alignas(CACHE_LINE_SIZE) here: padding is the pool's job (Traits::SlotLayout)
+struct Order {
     uint64_t id;
     double price;
     int quantity;
@@ -142,33 +4080,660 @@ struct alignas(CACHE_LINE_SIZE) Order {
     }
 };
 
-int main() {
+// Owns a preallocated fill buffer: worth building once, not once per order
+struct WorkingOrder {
+    uint64_t id = 0;
+    std::vector<double> fills;
+
+    WorkingOrder() { fills.reserve(64); }
+
+    //Called by WarmObjectPool::release(); clear() keeps the buffer
+    void reset() noexcept {
+        id = 0;
+        fills.clear();
+    }
+};
+
+// Pools handed to PoolPtr need static storage duration
+static LockFreeFixedSizeMemoryPool<Order, 1024> sharedOrderPool;
+
+// Orders touched by several threads: give each slot its own cache line
+struct PaddedOrderTraits : DefaultPoolTraits {
+    using SlotLayout = CacheLinePaddedSlots;
+};
+
+// Counters are compiled in only when asked for
+struct CountedOrderTraits : DefaultPoolTraits {
+    static constexpr bool STATS = true;
+};
+
+// End-of-day sweeps walk the pool itself, no intrusive list of live orders
+struct TrackedOrderTraits : DefaultPoolTraits {
+    static constexpr bool TRACK_LIVE = true;
+};
+
+#if LOCKFREE_POOL_HAS_COROUTINES
+// A full pool suspends the gateway's coroutines instead of failing them
+struct AwaitableOrderTraits : DefaultPoolTraits {
+    static constexpr bool AWAITABLE = true;
+};
+using GatewayPool = LockFreeFixedSizeMemoryPool<Order, 2, AwaitableOrderTraits>;
+
+// Smallest fire-and-forget coroutine type, just enough for the demo
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+DetachedTask handleOrder(GatewayPool& pool, std::uint64_t id) {
+    Order* slot = co_await pool.async_allocate();
+    Order* order = new (slot) Order(id, 106.50, 5);
+    order->print();
+    pool.destroy(order);
+}
+#endif
+
+// ========== Stress Harness ========== //
+/*
+ * `--stress [ops]` runs this instead of the demo. Each scenario starts
+ * rounds of short-lived workers on one pool. Every worker does `ops`
+ * random allocate, allocate_bulk, deallocate, deallocate_bulk, hand-off
+ * and flush_thread_cache calls, then exits with whatever it still caches.
+ * Hand-offs go through shared mailboxes, so slots are freed by threads
+ * that never allocated them.
+ *
+ * Every slot a worker holds is claimed in a flag array. Two holders of one
+ * slot, or a release of a slot nobody holds, count as failures. So does a
+ * stamp that changes while a slot is held, because it means the free list
+ * wrote into a live object. After the last round, main() drains the pool
+ * and must get exactly max_slabs() * N distinct slots.
+ *
+ * With `lateFrees`, each worker also keeps a few slots in a thread_local
+ * built before its first pool call. They are freed from that object's
+ * destructor, after the thread's index has gone back to the registry.
+ *
+ * Growable, eagerly linked pools also run a trimmer thread that calls
+ * trim() throughout each round, so slabs are released and revived under
+ * the workers' feet. When the threads cannot hold every slot between them,
+ * an allocate() that returns nullptr there is a failure too: trim() only
+ * hides the free list for a moment.
+ *
+ * AWAITABLE pools (C++20) also start coroutines that co_await a slot and
+ * post it for some worker to adopt. Once every slot is back, none of them
+ * may still be parked: that would be a lost wakeup.
+ *
+ * Build with -DLOCKFREE_POOL_STRESS_PREEMPT=1 so the CAS loops yield between
+ * snapshot and CAS. A pool without the head tag then corrupts its free list
+ * within seconds, even on one core. Build with -fsanitize=thread to check the
+ * same schedules for races, and with -DLOCKFREE_POOL_HAS_DWCAS=0 to cover
+ * the packed 48+16-bit head.
+ */
+struct StressSlot {
+    std::uint64_t stamp;
+    std::uint64_t spare;
+};
+
+//One-node magazines over six slots: nearly every call pops or pushes the shared head
+struct AbaStormTraits : DefaultPoolTraits {
+    static constexpr std::size_t MAGAZINE_SIZE = 1;
+};
+
+struct IndexedStressTraits : DefaultPoolTraits {
+    static constexpr bool INDEXED_FREE_LIST = true;
+};
+
+//Same storm with every ordering strengthened; its result should never differ
+struct SeqCstStressTraits : AbaStormTraits {
+    using Ordering = SeqCstOrdering;
+};
+
+struct RemoteFreeStressTraits : DefaultPoolTraits {
+    static constexpr bool REMOTE_FREE = true;
+};
+
+struct PerCpuStressTraits : DefaultPoolTraits {
+    static constexpr bool PER_CPU_CACHE = true;
+    static constexpr std::size_t MAGAZINE_SIZE = 8;
+};
+
+//A small pool runs dry often, so coroutines park and are woken by every path
+struct AwaitableStressTraits : DefaultPoolTraits {
+    static constexpr bool AWAITABLE = true;
+};
+
+//Waiters must also see slots stranded on other CPUs' magazines
+struct AwaitablePerCpuStressTraits : AwaitableStressTraits {
+    static constexpr bool PER_CPU_CACHE = true;
+};
+
+//Slabs leave and come back while workers churn; stale walks must stay in bounds
+struct TrimStressTraits : DefaultPoolTraits {
+    using ExhaustionPolicy = GrowOnExhaustion;
+    static constexpr std::size_t MAX_SLABS = 4;
+    static constexpr bool SAFE_RECLAIM = true;
+    static constexpr std::size_t TRIM_DECAY = 1;
+};
+
+//Slabs are carved lazily and added under contention
+struct GrowingStressTraits : DefaultPoolTraits {
+    using ExhaustionPolicy = GrowOnExhaustion;
+    static constexpr std::size_t MAX_SLABS = 4;
+    static constexpr bool LAZY_INIT = true;
+    static constexpr bool TRACK_LIVE = true;
+};
+
+template<std::size_t N, typename Traits>
+class StressRun {
+    using Pool = LockFreeFixedSizeMemoryPool<StressSlot, N, Traits>;
+
+public:
+    static constexpr std::size_t SLOTS = Pool::max_slabs() * N;
+    static constexpr std::size_t MAILBOXES = 64;
+    static constexpr std::size_t MAX_HELD = 48;
+    static constexpr std::size_t MAX_BURST = 16;
+    static constexpr std::size_t MAX_WAITING = 16;
+    static constexpr bool TRIMS = Pool::max_slabs() > 1 && !Traits::LAZY_INIT;
+    //Most one worker can hold, in hand and cached
+    static constexpr std::size_t WORKER_PEAK = MAX_HELD + MAX_BURST + 1 + 2 * Traits::MAGAZINE_SIZE;
+
+    explicit StressRun(std::size_t ops, bool lateFrees = false)
+        : opsPerThread(ops), lateFrees(lateFrees), claimed(new std::atomic<std::uint8_t>[SLOTS]) {
+        for (std::size_t i = 0; i < SLOTS; ++i) claimed[i].store(0, std::memory_order_relaxed);
+        for (auto& box : mailboxes) box.store(nullptr, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Runs `rounds` rounds of `threads` workers, then drains the pool.
+     * @return Number of conservation failures; 0 means every slot was accounted for.
+     */
+    std::size_t run(std::size_t rounds, std::size_t threads) {
+        //The trimmer holds up to a slab plus its magazines
+        spareCapacity = TRIMS && threads * WORKER_PEAK + N + 2 * Traits::MAGAZINE_SIZE + MAILBOXES <= SLOTS;
+        for (std::size_t round = 0; round < rounds; ++round) {
+            std::vector<std::thread> workers;
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([this, seed = round * threads + t + 1] { work(seed); });
+            }
+            std::atomic<bool> stop{false};
+            std::thread trimmer;
+            if constexpr (TRIMS) {
+                trimmer = std::thread([this, &stop] { trimLoop(stop); });
+            }
+            for (std::thread& worker : workers) worker.join();
+            stop.store(true, std::memory_order_relaxed);
+            if (trimmer.joinable()) trimmer.join();
+        }
+#if LOCKFREE_POOL_HAS_COROUTINES
+        if constexpr (Traits::AWAITABLE) {
+            //Workers are gone: a coroutine still parked while a slot is free was never woken
+            if (waiting.load() != 0) {
+                if (StressSlot* slot = pool.allocate()) {
+                    ++failures;
+                    pool.deallocate(slot);
+                }
+            }
+        }
+#endif
+
+        for (auto& box : mailboxes) {
+            if (StressSlot* slot = box.exchange(nullptr, std::memory_order_acquire)) {
+                release(slot, slot->stamp);
+                pool.deallocate(slot);
+            }
+        }
+#if LOCKFREE_POOL_HAS_COROUTINES
+        if constexpr (Traits::AWAITABLE) {
+            //Freeing an adopted slot may resume another waiter, which posts again
+            for (;;) {
+                std::vector<Held> adopted;
+                {
+                    std::lock_guard<std::mutex> lock(arrivalMutex);
+                    adopted.swap(arrivals);
+                }
+                if (adopted.empty()) break;
+                for (const Held& h : adopted) {
+                    release(h.slot, h.stamp);
+                    pool.deallocate(h.slot);
+                }
+            }
+            if (waiting.load() != 0) ++failures;
+            checkExitWakeup();
+        }
+#endif
+        if constexpr (Traits::TRACK_LIVE) {
+            if (pool.live_count() != 0) ++failures;
+        }
+        //Workers left slots on whichever CPUs they ran on, not only on ours
+        if constexpr (Traits::PER_CPU_CACHE) {
+            pool.flush_cpu_caches();
+        }
+
+        std::vector<StressSlot*> drained;
+        while (StressSlot* slot = pool.allocate()) {
+            if (drained.size() == SLOTS) {
+                ++failures;   // More slots than the pool has: one is on the free list twice
+                break;
+            }
+            claim(slot, 0);
+            drained.push_back(slot);
+        }
+        if (drained.size() != SLOTS) ++failures;
+        for (StressSlot* slot : drained) {
+            release(slot, 0);
+            pool.deallocate(slot);
+        }
+        return failures.load();
+    }
+
+    // Slabs the trimmer released over the whole run
+    std::size_t trims() const noexcept {
+        return trimmed;
+    }
+
+private:
+    struct Held {
+        StressSlot* slot;
+        std::uint64_t stamp;
+    };
+
+    // Freed when the worker's thread_locals are destroyed, after its index was released
+    struct LateFrees {
+        StressRun* run = nullptr;
+        std::vector<Held> held;
+
+        ~LateFrees() {
+            for (const Held& h : held) {
+                run->release(h.slot, h.stamp);
+                run->pool.deallocate(h.slot);
+            }
+        }
+    };
+
+    void claim(StressSlot* slot, std::uint64_t stamp) noexcept {
+        if (claimed[pool.handle_of(slot)].exchange(1, std::memory_order_acq_rel) != 0) ++failures;
+        slot->stamp = stamp;
+    }
+
+    void release(StressSlot* slot, std::uint64_t stamp) noexcept {
+        if (slot->stamp != stamp) ++failures;
+        if (claimed[pool.handle_of(slot)].exchange(0, std::memory_order_acq_rel) != 1) ++failures;
+    }
+
+    // Grows the pool by a slab's worth, hands it all back, then trims: whole
+    // slabs go idle and are released while the workers keep popping
+    void trimLoop(const std::atomic<bool>& stop) {
+        std::vector<StressSlot*> burst(N);
+        std::uint64_t sequence = std::uint64_t{1} << 63;
+        while (!stop.load(std::memory_order_relaxed)) {
+            //allocate(), not allocate_bulk(): only the single pop grows the pool
+            std::size_t got = 0;
+            while (got < N) {
+                StressSlot* slot = pool.allocate();
+                if (!slot) break;
+                burst[got++] = slot;
+                claim(slot, ++sequence);
+            }
+            for (std::size_t i = 0; i < got; ++i) release(burst[i], sequence - got + 1 + i);
+            pool.deallocate_bulk(burst.data(), got);
+            pool.flush_thread_cache();
+            trimmed += pool.trim();
+            trimmed += pool.trim();
+            std::this_thread::yield();
+        }
+    }
+
+#if LOCKFREE_POOL_HAS_COROUTINES
+    // Resumed on whichever thread returns slots; the slot waits in `arrivals`
+    DetachedTask awaitSlot(std::uint64_t stamp) {
+        StressSlot* slot = co_await pool.async_allocate();
+        claim(slot, stamp);
+        {
+            std::lock_guard<std::mutex> lock(arrivalMutex);
+            arrivals.push_back({slot, stamp});
+        }
+        waiting.fetch_sub(1);
+    }
+
+    /**
+     * @brief One thread caches every free slot, a coroutine parks, the thread exits.
+     *
+     * Only that thread's exit flush can wake the coroutine; if it does not,
+     * the coroutine is still parked after the join.
+     */
+    void checkExitWakeup() {
+        static_assert(2 * Traits::MAGAZINE_SIZE >= SLOTS, "the hoarder must cache the whole pool");
+        pool.flush_thread_cache();
+        std::atomic<int> phase{0};
+        std::thread hoarder([&] {
+            std::vector<StressSlot*> all;
+            while (StressSlot* slot = pool.allocate()) all.push_back(slot);
+            for (StressSlot* slot : all) pool.deallocate(slot);
+            phase.store(1);
+            while (phase.load() != 2) std::this_thread::yield();
+        });
+        while (phase.load() != 1) std::this_thread::yield();
+        waiting.fetch_add(1);
+        awaitSlot(0);
+        phase.store(2);
+        hoarder.join();
+        if (waiting.load() != 0) ++failures;
+
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        for (const Held& h : arrivals) {
+            release(h.slot, h.stamp);
+            pool.deallocate(h.slot);
+        }
+        arrivals.clear();
+    }
+#endif
+
+    void work(std::uint64_t seed) {
+        //Built before this thread's first pool call, so destroyed after its index goes back
+        thread_local LateFrees late;
+        late.run = this;
+        std::uint64_t rng = seed * 0x9E3779B97F4A7C15ull;
+        auto next = [&rng] {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            return rng;
+        };
+        std::uint64_t sequence = seed << 32;
+        std::vector<Held> held;
+        held.reserve(MAX_HELD + MAX_BURST);
+        std::array<StressSlot*, MAX_BURST> burst{};
+
+        for (std::size_t op = 0; op < opsPerThread; ++op) {
+            const std::uint64_t r = next();
+            switch (r % 16) {
+            case 0: case 1: case 2: case 3: case 4:
+                if (held.size() < MAX_HELD) {
+                    if (StressSlot* slot = pool.allocate()) {
+                        claim(slot, ++sequence);
+                        held.push_back({slot, sequence});
+                    } else if (spareCapacity) {
+                        ++failures;
+                    }
+                }
+                break;
+            case 5: case 6: {
+                const std::size_t want = 1 + (r >> 8) % MAX_BURST;
+                const std::size_t got = pool.allocate_bulk(burst.data(), want);
+                for (std::size_t i = 0; i < got; ++i) {
+                    claim(burst[i], ++sequence);
+                    held.push_back({burst[i], sequence});
+                }
+                break;
+            }
+            case 7: case 8: case 9: case 10:
+                if (!held.empty()) {
+                    const std::size_t pick = (r >> 8) % held.size();
+                    release(held[pick].slot, held[pick].stamp);
+                    pool.deallocate(held[pick].slot);
+                    held[pick] = held.back();
+                    held.pop_back();
+                }
+                break;
+            case 11: case 12: {
+                const std::size_t count = std::min<std::size_t>(held.size(), 1 + (r >> 8) % MAX_BURST);
+                for (std::size_t i = 0; i < count; ++i) {
+                    release(held.back().slot, held.back().stamp);
+                    burst[i] = held.back().slot;
+                    held.pop_back();
+                }
+                pool.deallocate_bulk(burst.data(), count);
+                break;
+            }
+            case 13: case 14: {
+                //Swap with a mailbox: the slot we post is freed or kept by some other thread
+                StressSlot* outgoing = nullptr;
+                if (!held.empty()) {
+                    outgoing = held.back().slot;
+                    held.pop_back();
+                }
+                auto& box = mailboxes[(r >> 8) % MAILBOXES];
+                if (StressSlot* incoming = box.exchange(outgoing, std::memory_order_acq_rel)) {
+                    held.push_back({incoming, incoming->stamp});
+                }
+                break;
+            }
+            default:
+                if ((r >> 8) % 64 == 0) pool.flush_thread_cache();
+#if LOCKFREE_POOL_HAS_COROUTINES
+                if constexpr (Traits::AWAITABLE) {
+                    //Start a waiter, or adopt a slot one was resumed with
+                    if ((r >> 14) % 2 == 0) {
+                        if (waiting.load(std::memory_order_relaxed) < MAX_WAITING) {
+                            waiting.fetch_add(1);
+                            awaitSlot(++sequence);
+                        }
+                    } else {
+                        std::lock_guard<std::mutex> lock(arrivalMutex);
+                        if (!arrivals.empty()) {
+                            held.push_back(arrivals.back());
+                            arrivals.pop_back();
+                        }
+                    }
+                }
+#endif
+                break;
+            }
+        }
+
+        //Exit with a loaded magazine: the registry has to hand it back
+        for (const Held& h : held) {
+            if (lateFrees && late.held.size() < MAX_BURST) {
+                late.held.push_back(h);
+                continue;
+            }
+            release(h.slot, h.stamp);
+            pool.deallocate(h.slot);
+        }
+    }
+
+    Pool pool;
+    const std::size_t opsPerThread;
+    const bool lateFrees;
+    std::unique_ptr<std::atomic<std::uint8_t>[]> claimed;
+    std::array<std::atomic<StressSlot*>, MAILBOXES> mailboxes;
+    std::atomic<std::size_t> failures{0};
+    std::size_t trimmed = 0;
+    bool spareCapacity = false;
+    //Coroutines started and not yet resumed, and the slots they were given
+    std::atomic<std::size_t> waiting{0};
+    std::mutex arrivalMutex;
+    std::vector<Held> arrivals;
+};
+
+template<std::size_t N, typename Traits = DefaultPoolTraits>
+std::size_t stressScenario(const char* name, std::size_t ops, std::size_t threads, bool lateFrees = false) {
+    StressRun<N, Traits> run(ops, lateFrees);
+    const std::size_t failures = run.run(4, threads);
+    std::cout << "  " << name << ": " << (failures ? "FAILED" : "ok")
+              << " (" << StressRun<N, Traits>::SLOTS << " slots, " << threads << " threads x 4 rounds";
+    if (StressRun<N, Traits>::TRIMS) std::cout << ", " << run.trims() << " slabs trimmed";
+    if (failures) std::cout << ", " << failures << " failures";
+    std::cout << ")\n";
+    return failures;
+}
+
+int runStressSuite(std::size_t ops) {
+    const std::size_t threads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 4, 16);
+    std::cout << "Stress: " << ops << " ops per thread\n";
+    std::size_t failures = 0;
+    failures += stressScenario<1024>("default", ops, threads);
+    failures += stressScenario<6, AbaStormTraits>("aba-storm", ops, threads);
+    failures += stressScenario<6, SeqCstStressTraits>("aba-storm-seq-cst", ops, threads);
+    failures += stressScenario<1024, IndexedStressTraits>("indexed-head", ops, threads);
+    failures += stressScenario<1024, RemoteFreeStressTraits>("remote-free", ops, threads);
+    failures += stressScenario<1024, PerCpuStressTraits>("per-cpu", ops, threads);
+    failures += stressScenario<256, GrowingStressTraits>("growing-lazy", ops, threads);
+    failures += stressScenario<256, TrimStressTraits>("trim", ops, threads);
+    failures += stressScenario<1024>("thread-local-frees", ops, threads, true);
+    failures += stressScenario<1024, RemoteFreeStressTraits>("thread-local-frees-remote", ops, threads, true);
+#if LOCKFREE_POOL_HAS_COROUTINES
+    failures += stressScenario<64, AwaitableStressTraits>("awaitable", ops, threads);
+    failures += stressScenario<64, AwaitablePerCpuStressTraits>("awaitable-per-cpu", ops, threads);
+#endif
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--stress") == 0) {
+        return runStressSuite(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000);
+    }
+
     try {
         LockFreeFixedSizeMemoryPool<Order, 1024> pool;
+        std::cout << "Order slot: " << pool.slot_size() << " bytes packed, "
+                  << LockFreeFixedSizeMemoryPool<Order, 1024, PaddedOrderTraits>::slot_size()
+                  << " bytes cache-line padded\n";
 
-        Order* order1 = pool.allocate();
-        new (order1) Order(1001, 99.95, 200);
+        Order* order1 = pool.construct(1001, 99.95, 200);
         order1->print();
 
-        Order* order2 = pool.allocate();
-        new (order2) Order(1002, 101.25, 150);
+        Order* order2 = pool.construct(1002, 101.25, 150);
         order2->print();
 
-        order1->~Order();
-        pool.deallocate(order1);
+        pool.destroy(order1);
+        pool.destroy(order2);
+
+        // **Pool-backed ownership**: pointer-sized, returns to sharedOrderPool on scope exit
+        {
+            PoolPtr<sharedOrderPool> order = make_pooled<sharedOrderPool>(1003, 102.50, 75);
+            static_assert(sizeof(order) == sizeof(Order*), "PoolPtr must not carry a pool pointer");
+            order->print();
+        }
+
+        // **Compact handles**: 4-byte references for an order book's indices
+        {
+            const decltype(pool)::Handle handle = pool.allocate_handle();
+            new (pool.get(handle)) Order(1006, 105.25, 10);
+            pool.get(handle)->print();
+            pool.deallocate_handle(handle);
+        }
+
+        // **Node-based containers**: tree nodes from a per-node-type pool
+        {
+            std::map<std::uint64_t, double, std::less<>,
+                     PoolAllocator<std::pair<const std::uint64_t, double>, 256>> book;
+            book.emplace(1001, 99.95);
+            book.emplace(1002, 101.25);
+
+            //pmr: slot-sized list nodes from a pool, anything larger upstream
+            LockFreeFixedSizeMemoryPool<std::array<std::byte, 32>, 256> nodePool;
+            PoolMemoryResource resource(nodePool);
+            std::pmr::list<std::uint64_t> fills(&resource);
+            for (const auto& level : book) fills.push_back(level.first);
+            std::cout << "Book levels: " << book.size() << ", fills: " << fills.size() << "\n";
+        }
+
+        // **Size classes**: one allocator for every small message type
+        {
+            SizeClassAllocator<> messages;
+            Order* order = messages.construct<Order>(1004, 103.75, 50);
+            void* heartbeat = messages.allocate(10);
+            std::cout << "Order in " << messages.class_size(messages.class_index(sizeof(Order)))
+                      << "-byte class, 10-byte heartbeat in "
+                      << messages.class_size(messages.class_index(10)) << "-byte class\n";
+            messages.deallocate(heartbeat, 10);
+            messages.destroy(order);
+        }
+
+        // **Statistics**: how close a pool came to N, to size it from real load
+        {
+            LockFreeFixedSizeMemoryPool<Order, 1024, CountedOrderTraits> counted;
+            std::array<Order*, 100> burst{};
+            for (auto& slot : burst) slot = counted.construct(0, 0.0, 0);
+            for (Order* slot : burst) counted.destroy(slot);
+            const PoolStats stats = counted.snapshot();
+            std::cout << "Peak in use: " << stats.high_water_mark << " of " << counted.capacity()
+                      << ", magazine hits: " << stats.cache_hits << "/" << stats.allocations << "\n";
+        }
+
+        // **Warm objects**: constructed once, reset on release, never rebuilt
+        {
+            WarmObjectPool<WorkingOrder, 128> working;
+            WorkingOrder* order = working.acquire();
+            order->id = 4001;
+            order->fills.push_back(99.5);
+            const double* buffer = order->fills.data();
+            working.release(order);
+
+            WorkingOrder* next = working.acquire();
+            std::cout << "Reused working order: fill buffer "
+                      << (next->fills.data() == buffer ? "kept" : "reallocated")
+                      << ", capacity " << next->fills.capacity() << "\n";
+            working.release(next);
+        }
+
+        // **Live-object iteration**: reconcile every open order at end of day
+        {
+            LockFreeFixedSizeMemoryPool<Order, 1024, TrackedOrderTraits> book;
+            std::array<Order*, 10> open{};
+            for (std::size_t i = 0; i < open.size(); ++i) open[i] = book.construct(2000 + i, 100.0, 10);
+            book.destroy(open[3]);
+            int quantity = 0;
+            book.for_each_live([&](const Order* order) { quantity += order->quantity; });
+            std::cout << "Open orders: " << book.live_count() << ", total quantity: " << quantity << "\n";
+            for (std::size_t i = 0; i < open.size(); ++i) {
+                if (i != 3) book.destroy(open[i]);
+            }
+        }
+
+#if LOCKFREE_POOL_HAS_COROUTINES
+        // **Awaitable allocation**: backpressure without polling or a heap fallback
+        {
+            GatewayPool gateway;
+            Order* first = gateway.construct(3001, 106.00, 5);
+            Order* second = gateway.construct(3002, 106.25, 5);
+            handleOrder(gateway, 3003);   // Pool is full: parks
+            std::cout << "Order 3003 waits for a slot\n";
+            gateway.destroy(first);       // Hands the slot over and resumes it
+            gateway.destroy(second);
+        }
+#endif
 
-        order2->~Order();
-        pool.deallocate(order2);
+#if LOCKFREE_POOL_HAS_MMAP
+        // **Shared memory**: a feed handler and a strategy map one region; an
+        // order crosses over as a 32-bit handle, never copied
+        {
+            using SharedOrders = SharedLockFreeFixedSizeMemoryPool<Order, 256>;
+            SharedOrders::unlink("/lockfree_pool_demo");
+            SharedOrders feed("/lockfree_pool_demo", ShmOpen::Create);
+            SharedOrders strategy("/lockfree_pool_demo", ShmOpen::Attach);
+
+            const SharedOrders::Handle handle = feed.handle_of(new (feed.allocate()) Order(1005, 104.00, 25));
+            Order* received = strategy.get(handle);
+            received->print();
+            strategy.deallocate(received);
+            SharedOrders::unlink("/lockfree_pool_demo");
+        }
+#endif
 
         // **Stress test exhaustion**
         for (int i = 0; i < 1100; ++i) {
             Order* order = pool.allocate();
+            if (!order) break;
             new (order) Order(i, 100.0 + i, i * 10);
             order->print();
             order->~Order();
             pool.deallocate(order);
         }
 
+        // **Exhaustion policy**: default ReturnNullOnExhaustion, no heap fallback
+        std::array<Order*, 1024> held{};
+        for (auto& slot : held) slot = pool.allocate();
+        std::cout << "Allocate past capacity returns "
+                  << (pool.allocate() ? "a slot" : "nullptr")
+                  << ", exhaustion count = " << pool.exhaustion_count() << "\n";
+        for (Order* slot : held) pool.deallocate(slot);
+
     } catch (const std::bad_alloc& e) {
         std::cerr << "Fatal memory allocation failure: " << e.what() << "\n";
         return -1;
@@ -176,3 +4741,4 @@ int main() {
 
     return 0;
 }
+#endif // LOCKFREE_POOL_NO_EXAMPLE_MAIN
@@ -0,0 +1,553 @@
+/**
+ * @brief Google Benchmark suite for LockFreeFixedSizeMemoryPool.
+ *
+ * Every allocation pattern runs against the pool, operator new/delete and
+ * std::pmr::synchronized_pool_resource, on 1 to 64 threads. Each run reports
+ * throughput (items_per_second) and the p50/p99/p99.9 latency of a sample of
+ * allocate calls (ns, averaged over threads).
+ *
+ * Build (x86-64 needs -mcx16 for the 128-bit tagged head):
+ *   g++ -std=c++17 -O2 -mcx16 -pthread LockFreeFixedSizeMemoryPoolBenchmark.cpp -lbenchmark -o pool_bench
+ *
+ * On ARM64, pick the atomics explicitly; the "atomics" context line records it.
+ * -march=armv8.1-a (or later, e.g. -mcpu=neoverse-n1) inlines LSE CAS/CASP,
+ * where the requested ordering decides between CASA, CASL and CASAL:
+ *   g++ -std=c++17 -O2 -march=armv8.1-a -pthread ... -o pool_bench_lse
+ *   g++ -std=c++17 -O2 -march=armv8-a -mno-outline-atomics -pthread ... -o pool_bench_llsc
+ * BM_FreeListChurn<TaggedStack<...>> rows compare the orderings on one head;
+ * on x86 every LOCK-prefixed CAS is a full barrier, so they should tie there.
+ *
+ * jemalloc and tcmalloc replace malloc, so the NewDelete rows measure them
+ * when the same binary is run with either one preloaded or linked in; the
+ * "malloc" context line of the report records which one was active:
+ *   LD_PRELOAD=libjemalloc.so.2 ./pool_bench
+ *   LD_PRELOAD=libtcmalloc_minimal.so.4 ./pool_bench
+ *   g++ ... -ljemalloc -o pool_bench_je
+ */
+#define LOCKFREE_POOL_NO_EXAMPLE_MAIN
+#include "LockFreeFixedSizeMemoryPool.cpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // std::shuffle
+#include <chrono>   // std::chrono::steady_clock
+#include <random>   // std::mt19937
+#include <vector>   // std::vector
+
+// ========== Allocator Backends ========== //
+//A typical small message: one cache line
+struct Message {
+    std::uint64_t id;
+    double price;
+    std::int32_t quantity;
+    char payload[44];
+};
+
+//Room for every pattern at 64 threads plus two magazines per thread
+constexpr std::size_t POOL_CAPACITY = 1 << 16;
+
+//Randomized backoff plus double refills for threads that keep losing the CAS
+struct ContendedPoolTraits : DefaultPoolTraits {
+    using Backoff = RandomizedBackoff<>;
+    static constexpr std::size_t CONTENDED_REFILL_RETRIES = 2;
+};
+
+//Magazines shared by the threads of a CPU instead of owned by each thread
+struct PerCpuPoolTraits : DefaultPoolTraits {
+    static constexpr bool PER_CPU_CACHE = true;
+};
+
+template<typename Traits = DefaultPoolTraits>
+struct PoolBackend {
+    using Pool = LockFreeFixedSizeMemoryPool<Message, POOL_CAPACITY, Traits>;
+
+    static Pool& pool() {
+        static Pool* const instance = new Pool();
+        return *instance;
+    }
+
+    static Message* allocate() noexcept { return pool().allocate(); }
+    static void deallocate(Message* ptr) noexcept { pool().deallocate(ptr); }
+};
+
+struct NewDeleteBackend {
+    static Message* allocate() { return static_cast<Message*>(::operator new(sizeof(Message))); }
+    static void deallocate(Message* ptr) noexcept { ::operator delete(ptr); }
+};
+
+struct SynchronizedPmrBackend {
+    static std::pmr::synchronized_pool_resource& resource() {
+        static auto* const instance = new std::pmr::synchronized_pool_resource();
+        return *instance;
+    }
+
+    static Message* allocate() {
+        return static_cast<Message*>(resource().allocate(sizeof(Message), alignof(Message)));
+    }
+    static void deallocate(Message* ptr) noexcept {
+        resource().deallocate(ptr, sizeof(Message), alignof(Message));
+    }
+};
+
+// ========== Latency Sampling ========== //
+/**
+ * @brief Times every SAMPLE_EVERY-th allocate call of one benchmark thread.
+ *
+ * Timing every call would measure the clock more than the allocator; one in
+ * sixteen keeps the throughput numbers honest and still gives the tail.
+ * The median cost of an empty interval is subtracted from every sample.
+ */
+class LatencySampler {
+public:
+    static constexpr std::size_t SAMPLE_EVERY = 16;
+
+    template<typename Fn>
+    Message* allocate(Fn&& allocateFn) {
+        if (++calls % SAMPLE_EVERY != 0) {
+            return allocateFn();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        Message* ptr = allocateFn();
+        const auto stop = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        samples.push_back(std::max(0.0, ns - clockOverhead()));
+        return ptr;
+    }
+
+    //Per-thread percentiles, averaged over the benchmark's threads
+    void report(benchmark::State& state) {
+        if (samples.empty()) return;
+        std::sort(samples.begin(), samples.end());
+        auto at = [this](double q) {
+            return samples[std::min(samples.size() - 1, static_cast<std::size_t>(q * samples.size()))];
+        };
+        state.counters["p50_ns"] = benchmark::Counter(at(0.50), benchmark::Counter::kAvgThreads);
+        state.counters["p99_ns"] = benchmark::Counter(at(0.99), benchmark::Counter::kAvgThreads);
+        state.counters["p99.9_ns"] = benchmark::Counter(at(0.999), benchmark::Counter::kAvgThreads);
+    }
+
+private:
+    static double clockOverhead() {
+        static const double overhead = [] {
+            std::vector<double> empty(1001);
+            for (auto& ns : empty) {
+                const auto start = std::chrono::steady_clock::now();
+                const auto stop = std::chrono::steady_clock::now();
+                ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            }
+            std::nth_element(empty.begin(), empty.begin() + 500, empty.end());
+            return empty[500];
+        }();
+        return overhead;
+    }
+
+    std::size_t calls = 0;
+    std::vector<double> samples;
+};
+
+// ========== Allocation Patterns ========== //
+constexpr std::size_t WINDOW = 256;
+
+/**
+ * @brief Allocate one object, touch it, free it again on the same thread.
+ */
+template<typename Backend>
+void BM_Lifo(benchmark::State& state) {
+    LatencySampler sampler;
+    for (auto _ : state) {
+        Message* msg = sampler.allocate(Backend::allocate);
+        msg->id = 1;
+        benchmark::DoNotOptimize(msg);
+        Backend::deallocate(msg);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    sampler.report(state);
+}
+
+/**
+ * @brief Allocate a burst of WINDOW objects, then free them in allocation order.
+ */
+template<typename Backend>
+void BM_Burst(benchmark::State& state) {
+    LatencySampler sampler;
+    std::vector<Message*> burst(WINDOW);
+    for (auto _ : state) {
+        for (auto& msg : burst) {
+            msg = sampler.allocate(Backend::allocate);
+            msg->id = 1;
+        }
+        benchmark::ClobberMemory();
+        for (Message* msg : burst) Backend::deallocate(msg);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * WINDOW));
+    sampler.report(state);
+}
+
+/**
+ * @brief Keep WINDOW objects live and free them in a shuffled order, so the
+ *        free list ends up in no particular address order.
+ */
+template<typename Backend>
+void BM_RandomFree(benchmark::State& state) {
+    LatencySampler sampler;
+    std::vector<Message*> live(WINDOW);
+    std::vector<std::size_t> order(WINDOW);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::mt19937 rng(static_cast<std::uint32_t>(state.thread_index()));
+
+    //Shuffles are precomputed so the RNG stays out of the timed loop
+    constexpr std::size_t ORDERS = 64;
+    std::vector<std::vector<std::size_t>> orders(ORDERS, order);
+    for (auto& o : orders) std::shuffle(o.begin(), o.end(), rng);
+
+    std::size_t round = 0;
+    for (auto _ : state) {
+        for (auto& msg : live) {
+            msg = sampler.allocate(Backend::allocate);
+            msg->id = 1;
+        }
+        benchmark::ClobberMemory();
+        for (std::size_t index : orders[round++ % ORDERS]) Backend::deallocate(live[index]);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * WINDOW));
+    sampler.report(state);
+}
+
+//Single-producer/single-consumer ring shared by one thread pair
+struct alignas(CACHE_LINE_SIZE) HandoffRing {
+    static constexpr std::size_t SIZE = 1024;
+    std::array<Message*, SIZE> slots{};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};
+
+    void push(Message* msg) noexcept {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        while (t - head.load(std::memory_order_acquire) == SIZE) std::this_thread::yield();
+        slots[t % SIZE] = msg;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    Message* pop() noexcept {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        while (tail.load(std::memory_order_acquire) == h) std::this_thread::yield();
+        Message* msg = slots[h % SIZE];
+        head.store(h + 1, std::memory_order_release);
+        return msg;
+    }
+};
+
+/**
+ * @brief Even threads allocate, their odd partner frees: every object is
+ *        freed by a thread other than the one that allocated it.
+ *
+ * Both threads of a pair run the same number of iterations, so the ring is
+ * empty again when the run ends.
+ */
+template<typename Backend>
+void BM_ProducerConsumer(benchmark::State& state) {
+    static std::array<HandoffRing, 32> rings;
+    HandoffRing& ring = rings[static_cast<std::size_t>(state.thread_index()) / 2];
+    const bool producer = state.thread_index() % 2 == 0;
+
+    LatencySampler sampler;
+    for (auto _ : state) {
+        if (producer) {
+            Message* msg = sampler.allocate(Backend::allocate);
+            msg->id = 1;
+            ring.push(msg);
+        } else {
+            Backend::deallocate(ring.pop());
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    sampler.report(state);
+}
+
+#define POOL_BENCHMARK_PATTERN(PATTERN)                                                 \
+    BENCHMARK_TEMPLATE(PATTERN, PoolBackend<>)->ThreadRange(1, 64);                     \
+    BENCHMARK_TEMPLATE(PATTERN, PoolBackend<ContendedPoolTraits>)->ThreadRange(1, 64);  \
+    BENCHMARK_TEMPLATE(PATTERN, PoolBackend<PerCpuPoolTraits>)->ThreadRange(1, 64);     \
+    BENCHMARK_TEMPLATE(PATTERN, NewDeleteBackend)->ThreadRange(1, 64);                  \
+    BENCHMARK_TEMPLATE(PATTERN, SynchronizedPmrBackend)->ThreadRange(1, 64)
+
+POOL_BENCHMARK_PATTERN(BM_Lifo);
+POOL_BENCHMARK_PATTERN(BM_Burst);
+POOL_BENCHMARK_PATTERN(BM_RandomFree);
+
+#define POOL_BENCHMARK_PAIRS(PATTERN, BACKEND) \
+    BENCHMARK_TEMPLATE(PATTERN, BACKEND)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->Threads(32)->Threads(64)
+
+POOL_BENCHMARK_PAIRS(BM_ProducerConsumer, PoolBackend<>);
+POOL_BENCHMARK_PAIRS(BM_ProducerConsumer, PoolBackend<ContendedPoolTraits>);
+POOL_BENCHMARK_PAIRS(BM_ProducerConsumer, PoolBackend<PerCpuPoolTraits>);
+POOL_BENCHMARK_PAIRS(BM_ProducerConsumer, NewDeleteBackend);
+POOL_BENCHMARK_PAIRS(BM_ProducerConsumer, SynchronizedPmrBackend);
+
+/**
+ * @brief Fiber-style workers: every iteration starts 16 threads that each do
+ *        a short burst of work and exit, so per-thread caches start cold and
+ *        are flushed back at every exit.
+ */
+template<typename Backend>
+void BM_ShortLivedWorkers(benchmark::State& state) {
+    constexpr std::size_t WORKERS = 16;
+    constexpr std::size_t OPS = 512;
+    auto work = [] {
+        std::array<Message*, 16> live{};
+        for (std::size_t op = 0; op < OPS; op += live.size()) {
+            for (auto& msg : live) {
+                msg = Backend::allocate();
+                msg->id = op;
+            }
+            for (Message* msg : live) Backend::deallocate(msg);
+        }
+    };
+
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < WORKERS; ++i) workers.emplace_back(work);
+        for (auto& worker : workers) worker.join();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * WORKERS * OPS));
+}
+BENCHMARK_TEMPLATE(BM_ShortLivedWorkers, PoolBackend<>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ShortLivedWorkers, PoolBackend<PerCpuPoolTraits>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ShortLivedWorkers, NewDeleteBackend)->UseRealTime();
+
+// ========== Bulk API ========== //
+/**
+ * @brief The burst pattern through allocate_bulk()/deallocate_bulk().
+ */
+void BM_BurstBulk(benchmark::State& state) {
+    auto& pool = PoolBackend<>::pool();
+    const auto burst = static_cast<std::size_t>(state.range(0));
+    std::vector<Message*> objects(burst);
+    for (auto _ : state) {
+        const std::size_t got = pool.allocate_bulk(objects.data(), burst);
+        benchmark::DoNotOptimize(got);
+        pool.deallocate_bulk(objects.data(), got);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * burst));
+}
+BENCHMARK(BM_BurstBulk)->RangeMultiplier(2)->Range(32, 256);
+
+// ========== Cold Pointer Chasing ========== //
+struct NoPrefetchTraits : DefaultPoolTraits {
+    static constexpr bool PREFETCH_NEXT = false;
+};
+
+/**
+ * @brief Allocates a whole pool whose free list was shuffled, much larger
+ *        than L2: every pop follows `next` into memory that is likely cold.
+ *        Compares Traits::PREFETCH_NEXT on and off.
+ */
+template<typename Traits>
+void BM_ColdChase(benchmark::State& state) {
+    constexpr std::size_t SLOTS = 1 << 19;  // 32 MiB of Messages
+    static auto* const pool = new LockFreeFixedSizeMemoryPool<Message, SLOTS, Traits>();
+    std::vector<Message*> live(SLOTS);
+    std::mt19937 rng(42);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (auto& msg : live) msg = pool->allocate();
+        std::shuffle(live.begin(), live.end(), rng);
+        for (Message* msg : live) pool->deallocate(msg);
+        state.ResumeTiming();
+
+        for (auto& msg : live) {
+            msg = pool->allocate();
+            msg->id = 1;
+        }
+        benchmark::ClobberMemory();
+
+        state.PauseTiming();
+        for (Message* msg : live) pool->deallocate(msg);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SLOTS));
+}
+BENCHMARK_TEMPLATE(BM_ColdChase, DefaultPoolTraits)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColdChase, NoPrefetchTraits)->Unit(benchmark::kMillisecond);
+
+// ========== Live-Object Iteration ========== //
+struct TrackedPoolTraits : DefaultPoolTraits {
+    static constexpr bool TRACK_LIVE = true;
+};
+
+//What the occupancy bitmap costs allocate()/deallocate()
+BENCHMARK_TEMPLATE(BM_Lifo, PoolBackend<TrackedPoolTraits>)->ThreadRange(1, 64);
+
+/**
+ * @brief Sums a field of every live object in a 4M-slot pool, every other
+ *        slot live; arg 0 = for_each_live(), arg 1 = for_each_live_parallel().
+ */
+void BM_ForEachLive(benchmark::State& state) {
+    constexpr std::size_t SLOTS = 1 << 22;  // 256 MiB of Messages
+    using Pool = LockFreeFixedSizeMemoryPool<Message, SLOTS, TrackedPoolTraits>;
+    static Pool* const pool = [] {
+        auto* filled = new Pool();
+        std::vector<Message*> all(SLOTS);
+        for (auto& msg : all) {
+            msg = filled->allocate();
+            msg->quantity = 1;
+        }
+        for (std::size_t i = 0; i < SLOTS; i += 2) filled->deallocate(all[i]);
+        return filled;
+    }();
+
+    const bool parallel = state.range(0) != 0;
+    for (auto _ : state) {
+        std::atomic<std::int64_t> total{0};
+        auto visit = [&total](const Message* msg) { total.fetch_add(msg->quantity, std::memory_order_relaxed); };
+        if (parallel) {
+            pool->for_each_live_parallel(visit);
+        } else {
+            std::int64_t sum = 0;
+            pool->for_each_live([&sum](const Message* msg) { sum += msg->quantity; });
+            total.store(sum, std::memory_order_relaxed);
+        }
+        benchmark::DoNotOptimize(total.load(std::memory_order_relaxed));
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SLOTS / 2));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * SLOTS * sizeof(Message)));
+}
+BENCHMARK(BM_ForEachLive)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// ========== Warm Objects ========== //
+//Owns a heap buffer, like an order with preallocated fill storage
+struct BufferedOrder {
+    std::uint64_t id = 0;
+    std::vector<double> fills;
+
+    BufferedOrder() { fills.reserve(64); }
+    void reset() noexcept { fills.clear(); }
+};
+
+constexpr std::size_t WARM_CAPACITY = 1 << 12;
+
+//Rebuilt on every cycle: construct() + destroy() on a plain pool
+void BM_ColdObjects(benchmark::State& state) {
+    static auto* const pool = new LockFreeFixedSizeMemoryPool<BufferedOrder, WARM_CAPACITY>();
+    for (auto _ : state) {
+        BufferedOrder* order = pool->construct();
+        order->fills.push_back(1.0);
+        benchmark::DoNotOptimize(order);
+        pool->destroy(order);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ColdObjects)->ThreadRange(1, 8);
+
+//Built once: acquire() + release() with the reset() hook
+void BM_WarmObjects(benchmark::State& state) {
+    static auto* const pool = new WarmObjectPool<BufferedOrder, WARM_CAPACITY>();
+    for (auto _ : state) {
+        BufferedOrder* order = pool->acquire();
+        order->fills.push_back(1.0);
+        benchmark::DoNotOptimize(order);
+        pool->release(order);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_WarmObjects)->ThreadRange(1, 8);
+
+// ========== Free-List Head Contention ========== //
+struct BenchNode {
+    BenchNode* next;
+};
+
+// The loop allocate() used before the tagged head. ABA-unsafe: under heavy
+// churn it can lose or duplicate nodes, so only its throughput is meaningful.
+struct BarePointerStack {
+    alignas(CACHE_LINE_SIZE) std::atomic<BenchNode*> head{nullptr};
+
+    BenchNode* pop() noexcept {
+        BenchNode* h = head.load(std::memory_order_acquire);
+        while (h && !head.compare_exchange_weak(h, h->next, std::memory_order_acq_rel)) {
+        }
+        return h;
+    }
+
+    void push(BenchNode* node) noexcept {
+        BenchNode* h = head.load(std::memory_order_relaxed);
+        do {
+            node->next = h;
+        } while (!head.compare_exchange_weak(h, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+};
+
+// The pool's orderings before the audit: every pop CAS was acq_rel
+struct AcqRelOrdering : MinimalOrdering {
+    static constexpr std::memory_order POP = std::memory_order_acq_rel;
+};
+
+// Tagged head, as used by the pool, with the pool's ordering policies
+template<typename Ordering = MinimalOrdering>
+struct TaggedStack {
+    alignas(CACHE_LINE_SIZE) TaggedFreeListHead<BenchNode> head;
+
+    BenchNode* pop() noexcept {
+        auto h = head.load(Ordering::HEAD_LOAD);
+        while (h.ptr && !head.compare_exchange_weak(h, h.ptr->next, Ordering::POP, Ordering::POP_FAILURE)) {
+        }
+        return h.ptr;
+    }
+
+    void push(BenchNode* node) noexcept {
+        auto h = head.load(Ordering::PUSH_FAILURE);
+        do {
+            node->next = h.ptr;
+        } while (!head.compare_exchange_weak(h, node, Ordering::PUSH, Ordering::PUSH_FAILURE));
+    }
+};
+
+/**
+ * @brief Every thread pops and immediately pushes back one node, no magazines.
+ */
+template<typename Stack>
+void BM_FreeListChurn(benchmark::State& state) {
+    static Stack stack;
+    static std::array<BenchNode, 4 * 64> nodes;
+    if (state.thread_index() == 0) {
+        stack.head.store(nullptr, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < static_cast<std::size_t>(state.threads()) * 4; ++i) {
+            stack.push(&nodes[i]);
+        }
+    }
+    //Google Benchmark starts every thread's timed loop together, after setup
+    for (auto _ : state) {
+        if (BenchNode* node = stack.pop()) {
+            stack.push(node);
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK_TEMPLATE(BM_FreeListChurn, BarePointerStack)->ThreadRange(1, 32);
+BENCHMARK_TEMPLATE(BM_FreeListChurn, TaggedStack<MinimalOrdering>)->ThreadRange(1, 32);
+BENCHMARK_TEMPLATE(BM_FreeListChurn, TaggedStack<AcqRelOrdering>)->ThreadRange(1, 32);
+BENCHMARK_TEMPLATE(BM_FreeListChurn, TaggedStack<SeqCstOrdering>)->ThreadRange(1, 32);
+
+//Which instructions the CAS loops compile to, so ARM and x86 reports read alike
+constexpr const char* ATOMICS =
+#if defined(__aarch64__) && defined(__ARM_FEATURE_ATOMICS)
+    "aarch64 LSE (CAS/CASP inline)";
+#elif defined(__aarch64__)
+    "aarch64 LL/SC or outline-atomics";
+#elif defined(__x86_64__) || defined(__i386__)
+    "x86 LOCK CMPXCHG (full barrier at any ordering)";
+#else
+    "other";
+#endif
+
+int main(int argc, char** argv) {
+    const char* preload = std::getenv("LD_PRELOAD");
+    benchmark::AddCustomContext("malloc", preload && *preload ? preload : "default (linked)");
+    benchmark::AddCustomContext("dwcas", LOCKFREE_POOL_HAS_DWCAS ? "yes" : "no (packed 48/16)");
+    benchmark::AddCustomContext("atomics", ATOMICS);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}